@@ -127,6 +127,11 @@ HEADERS += src/skyscraper.h \
            src/fxcolorize.h \
            src/fxrotate.h \
            src/fxscanlines.h \
+           src/fxkernels.h \
+           src/taskpool.h \
+           src/imagewriter.h \
+           src/videoconverter.h \
+           src/fileexport.h \
            src/nametools.h \
            src/queue.h
 
@@ -180,6 +185,11 @@ SOURCES += src/main.cpp \
            src/fxcolorize.cpp \
            src/fxrotate.cpp \
            src/fxscanlines.cpp \
+           src/fxkernels.cpp \
+           src/taskpool.cpp \
+           src/imagewriter.cpp \
+           src/videoconverter.cpp \
+           src/fileexport.cpp \
            src/nametools.cpp \
            src/queue.cpp
 
@@ -30,18 +30,27 @@
 #include "platform.h"
 #include "strtools.h"
 
+#include <QDateTime>
 #include <QDomDocument>
 #include <QRegularExpression>
+#include <QTimer>
+#include <QUrl>
 
 AbstractScraper::AbstractScraper(Settings *config,
                                  QSharedPointer<NetManager> manager,
                                  MatchType type)
-    : config(config), type(type) {
+    : config(config), type(type), manager(manager) {
     netComm = new NetComm(manager);
+    netComm->setShared(true);
     connect(netComm, &NetComm::dataReady, &q, &QEventLoop::quit);
 }
 
-AbstractScraper::~AbstractScraper() { netComm->deleteLater(); }
+AbstractScraper::~AbstractScraper() {
+    netComm->deleteLater();
+    for (auto *comm : asyncIdle) {
+        comm->deleteLater();
+    }
+}
 
 void AbstractScraper::getSearchResults(QList<GameEntry> &gameEntries,
                                        QString searchName, QString platform) {
@@ -157,6 +166,8 @@ void AbstractScraper::populateGameEntry(GameEntry &game) {
         default:;
         }
     }
+    // Media getters may have left requests in flight
+    waitForRequests();
 }
 
 // TODO: openretro
@@ -436,15 +447,109 @@ void AbstractScraper::getVideo(GameEntry &game) {
 QByteArray AbstractScraper::downloadMedia(const QString &url, bool isImage) {
     netComm->request(url);
     q.exec();
+    return mediaFromReply(*netComm, isImage);
+}
+
+QByteArray AbstractScraper::mediaFromReply(NetComm &comm, bool isImage) {
     QByteArray d;
     QImage img;
-    if (netComm->getError() == QNetworkReply::NoError &&
-        (!isImage || img.loadFromData(netComm->getData()))) {
-        d = netComm->getData();
+    if (comm.getError() == QNetworkReply::NoError &&
+        (!isImage || img.loadFromData(comm.getData()))) {
+        d = comm.getData();
     }
     return d;
 }
 
+void AbstractScraper::requestAsync(const QString &url,
+                                   std::function<void(NetComm &)> onReady,
+                                   const int delay) {
+    asyncQueue.append({url, delay, onReady});
+    startAsyncRequests();
+}
+
+void AbstractScraper::downloadMediaAsync(
+    const QStringList &urls, std::function<void(QByteArray)> onReady,
+    bool isImage) {
+    if (urls.isEmpty()) {
+        onReady(QByteArray());
+        return;
+    }
+    // Try the urls in order, the first one that delivers wins
+    requestAsync(urls.first(), [this, urls, onReady, isImage](NetComm &comm) {
+        QByteArray d = mediaFromReply(comm, isImage);
+        if (d.isEmpty() && urls.size() > 1) {
+            downloadMediaAsync(urls.mid(1), onReady, isImage);
+        } else {
+            onReady(d);
+        }
+    });
+}
+
+void AbstractScraper::startAsyncRequests() {
+    while (!asyncQueue.isEmpty() &&
+           asyncCallbacks.size() < qMax(1, config->inFlight)) {
+        AsyncRequest req = asyncQueue.takeFirst();
+        NetComm *comm = nullptr;
+        if (asyncIdle.isEmpty()) {
+            comm = new NetComm(manager);
+            comm->setShared(true);
+            connect(comm, &NetComm::dataReady, this,
+                    [this, comm]() { asyncReady(comm); });
+        } else {
+            comm = asyncIdle.takeLast();
+        }
+        asyncCallbacks[comm] = req.onReady;
+        int wait = qMax(req.delay, reserveRequestSlot());
+        if (wait > 0) {
+            QString url = req.url;
+            QTimer::singleShot(wait, comm,
+                               [comm, url]() { comm->request(url); });
+        } else {
+            comm->request(req.url);
+        }
+    }
+}
+
+void AbstractScraper::asyncReady(NetComm *comm) {
+    std::function<void(NetComm &)> onReady = asyncCallbacks.value(comm);
+    onReady(*comm);
+    asyncCallbacks.remove(comm);
+    asyncIdle.append(comm);
+    startAsyncRequests();
+    if (asyncCallbacks.isEmpty() && asyncQueue.isEmpty()) {
+        asyncLoop.quit();
+    }
+}
+
+void AbstractScraper::waitForRequests() {
+    if (!asyncCallbacks.isEmpty() || !asyncQueue.isEmpty()) {
+        asyncLoop.exec();
+    }
+}
+
+int AbstractScraper::reserveRequestSlot() {
+    if (requestInterval <= 0) {
+        return 0;
+    }
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 slot = qMax(now, nextRequestAt);
+    nextRequestAt = slot + requestInterval;
+    return (int)(slot - now);
+}
+
+void AbstractScraper::waitForRequestSlot() {
+    int wait = reserveRequestSlot();
+    if (wait > 0) {
+        QEventLoop loop;
+        QTimer::singleShot(wait, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+}
+
+bool AbstractScraper::serviceDown() {
+    return !baseUrl.isEmpty() && NetComm::isHostDown(QUrl(baseUrl).host());
+}
+
 void AbstractScraper::nomNom(const QString nom, bool including) {
     data.remove(0, data.indexOf(nom.toUtf8()) + (including ? nom.length() : 0));
 }
@@ -691,6 +796,36 @@ void AbstractScraper::runPasses(QList<GameEntry> &gameEntries,
     }
 }
 
+void AbstractScraper::prefetchBatch(const QList<QFileInfo> &infos) {
+    // Results of a previous batch that were never asked for are stale now
+    batchResults.clear();
+    if (!config->searchName.isEmpty()) {
+        return;
+    }
+    QStringList searchNames;
+    for (const auto &info : infos) {
+        // Only the first pass is batched, further passes are rare enough
+        QString debug;
+        QList<QString> names = getSearchNames(info, debug);
+        if (!names.isEmpty() && !searchNames.contains(names.first())) {
+            searchNames.append(names.first());
+        }
+    }
+    if (searchNames.size() > 1) {
+        getBatchResults(searchNames, batchResults);
+    }
+}
+
+bool AbstractScraper::takeBatchResult(const QString &searchName,
+                                      QByteArray &reply) {
+    if (!batchResults.contains(searchName)) {
+        return false;
+    }
+    // Not taken, several ROMs of a batch may share a search name
+    reply = batchResults.value(searchName);
+    return true;
+}
+
 bool AbstractScraper::platformMatch(QString found, QString platform) {
     for (const auto &p : Platform::get().getAliases(platform)) {
         if (found.toLower() == p) {
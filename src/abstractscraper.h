@@ -35,8 +35,11 @@
 #include <QFileInfo>
 #include <QImage>
 #include <QList>
+#include <QMap>
 #include <QSettings>
 
+#include <functional>
+
 class AbstractScraper : public QObject {
     Q_OBJECT
 
@@ -55,6 +58,14 @@ public:
 
     int reqRemaining = -1;
     MatchType getType() const { return type; };
+    bool serviceDown();
+
+    // Batched lookup. Scrapers whose service accepts several games per query
+    // return a batch size > 1 and implement getBatchResults(). The worker then
+    // hands over upcoming queue entries with prefetchBatch(), and
+    // getSearchResults() picks up the per ROM reply with takeBatchResult().
+    virtual int getBatchSize() { return 1; }
+    void prefetchBatch(const QList<QFileInfo> &infos);
 
 #ifdef TESTING
     QList<QString> getRegionPrios() { return regionPrios; }
@@ -90,12 +101,39 @@ protected:
     virtual bool platformMatch(QString found, QString platform);
     virtual int getPlatformId(const QString);
     virtual QString applyQuerySearchName(QString query) { return query; };
+    // Fills results with the raw reply per search name, as if each name had
+    // been queried on its own. Names without a result are left out and will
+    // be looked up one by one.
+    virtual void getBatchResults(const QStringList &searchNames,
+                                 QMap<QString, QByteArray> &results) {
+        (void)searchNames;
+        (void)results;
+    };
+    bool takeBatchResult(const QString &searchName, QByteArray &reply);
 
     QString lookupSearchName(const QFileInfo &info, const QString &baseName,
                              QString &debug);
     QString lookupAliasMap(const QString &baseName, QString &debug);
     QByteArray downloadMedia(const QString &url, bool isImage = true);
 
+    // Asynchronous requests. Up to config->inFlight of them run at once per
+    // scraper, the callback is invoked on this thread once the reply is in.
+    // Callbacks may queue follow-up requests. Call waitForRequests() before
+    // using anything the callbacks produce. populateGameEntry() does so.
+    void requestAsync(const QString &url,
+                      std::function<void(NetComm &)> onReady,
+                      const int delay = 0);
+    void downloadMediaAsync(const QStringList &urls,
+                            std::function<void(QByteArray)> onReady,
+                            bool isImage = true);
+    void waitForRequests();
+    // Blocks until the next request may be started as per requestInterval
+    void waitForRequestSlot();
+    static QByteArray mediaFromReply(NetComm &comm, bool isImage);
+
+    // Minimum time in ms between the start of two requests, 0 = no limit
+    int requestInterval = 0;
+
     MatchType type = ABSTRACT;
 
     QList<int> fetchOrder;
@@ -152,6 +190,24 @@ protected:
     QEventLoop q; // Event loop for use when waiting for data from NetComm.
 
 private:
+    struct AsyncRequest {
+        QString url;
+        int delay;
+        std::function<void(NetComm &)> onReady;
+    };
+
+    void startAsyncRequests();
+    void asyncReady(NetComm *comm);
+    int reserveRequestSlot();
+
+    QSharedPointer<NetManager> manager;
+    QList<AsyncRequest> asyncQueue;
+    QList<NetComm *> asyncIdle;
+    QMap<NetComm *, std::function<void(NetComm &)>> asyncCallbacks;
+    QEventLoop asyncLoop;
+    qint64 nextRequestAt = 0;
+    QMap<QString, QByteArray> batchResults;
+
     QString lookupArcadeTitle(const QString &baseName);
 #ifndef TESTING
     void detectRegionFromFilename(const QFileInfo &info);
@@ -60,11 +60,13 @@ ArcadeDB::ArcadeDB(Settings *config, QSharedPointer<NetManager> manager)
 
 void ArcadeDB::getSearchResults(QList<GameEntry> &gameEntries,
                                 QString searchName, QString platform) {
-    QString url = searchUrlPre + searchName;
-    qDebug() << url;
-    netComm->request(url);
-    q.exec();
-    data = netComm->getData();
+    if (!takeBatchResult(searchName, data)) {
+        QString url = searchUrlPre + searchName;
+        qDebug() << url;
+        netComm->request(url);
+        q.exec();
+        data = netComm->getData();
+    }
 
     if (data.indexOf("{\"release\":1,\"result\":[]}") != -1) {
         return;
@@ -87,6 +89,46 @@ void ArcadeDB::getSearchResults(QList<GameEntry> &gameEntries,
     gameEntries.append(game);
 }
 
+void ArcadeDB::getBatchResults(const QStringList &searchNames,
+                               QMap<QString, QByteArray> &results) {
+    // The service takes several MAME names separated by ';' and answers with
+    // one result object per known name
+    QString url = searchUrlPre + searchNames.join(";");
+    qDebug() << url;
+    netComm->request(url);
+    q.exec();
+    QJsonParseError parseError;
+    QJsonObject jsonReply =
+        QJsonDocument::fromJson(netComm->getData(), &parseError).object();
+    if (netComm->getError() != QNetworkReply::NoError ||
+        parseError.error != QJsonParseError::NoError ||
+        !jsonReply.value("result").isArray()) {
+        // Leave all names out, they are looked up one by one instead
+        return;
+    }
+    const QJsonArray jsonResults = jsonReply.value("result").toArray();
+    for (const auto &jsonResult : jsonResults) {
+        const QString gameName =
+            jsonResult.toObject().value("game_name").toString();
+        for (const auto &searchName : searchNames) {
+            if (gameName.compare(searchName, Qt::CaseInsensitive) == 0) {
+                QJsonObject reply;
+                reply.insert("release", 1);
+                reply.insert("result", QJsonArray({jsonResult}));
+                results.insert(searchName, QJsonDocument(reply).toJson(
+                                               QJsonDocument::Compact));
+                break;
+            }
+        }
+    }
+    // A valid reply without a name means the service does not know it
+    for (const auto &searchName : searchNames) {
+        if (!results.contains(searchName)) {
+            results.insert(searchName, "{\"release\":1,\"result\":[]}");
+        }
+    }
+}
+
 void ArcadeDB::getGameData(GameEntry &game) { populateGameEntry(game); }
 
 void ArcadeDB::getReleaseDate(GameEntry &game) {
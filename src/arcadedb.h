@@ -36,12 +36,15 @@ class ArcadeDB : public AbstractScraper {
 
 public:
     ArcadeDB(Settings *config, QSharedPointer<NetManager> manager);
+    int getBatchSize() override { return 50; }
 
 private:
     QList<QString> getSearchNames(const QFileInfo &info,
                                   QString &debug) override;
     void getSearchResults(QList<GameEntry> &gameEntries, QString searchName,
                           QString platform) override;
+    void getBatchResults(const QStringList &searchNames,
+                         QMap<QString, QByteArray> &results) override;
     void getGameData(GameEntry &game) override;
     void getReleaseDate(GameEntry &game) override;
     void getPlayers(GameEntry &game) override;
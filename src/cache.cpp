@@ -27,9 +27,11 @@
 
 #include "cli.h"
 #include "config.h"
+#include "imgtools.h"
 #include "nametools.h"
 #include "queue.h"
 #include "skyscraper.h"
+#include "taskpool.h"
 
 #include <QBuffer>
 #include <QDateTime>
@@ -37,12 +39,14 @@
 #include <QDir>
 #include <QDomDocument>
 #include <QFile>
-#include <QProcess>
 #include <QRegularExpression>
+#include <QSaveFile>
 #include <QSet>
 #include <QStringBuilder>
+#include <QVector>
 #include <QXmlStreamAttributes>
 #include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 #include <iostream>
 
 // user defined resource cache entries
@@ -57,6 +61,13 @@ const QString ATTR_SHA1_LEGACY = "sha1";
 const QString ATTR_SRC = "source";
 const QString ATTR_TS = "timestamp";
 const QString ATTR_TYPE = "type";
+// Image resources, see ImageInfo
+const QString ATTR_WIDTH = "width";
+const QString ATTR_HEIGHT = "height";
+const QString ATTR_FORMAT = "format";
+const QString ATTR_PIXELS = "pixelformat";
+const QString ATTR_ALPHA = "alpha";
+const QString ATTR_CONTENT = "content";
 
 static inline QStringList txtTypes(bool useGenres = true) {
     // keep order for cache edit menu
@@ -81,11 +92,45 @@ static inline QStringList binTypes(bool withVideo = true,
     return binTypes;
 };
 
+static void readImageInfo(const QXmlStreamAttributes &attribs,
+                          ImageInfo &info) {
+    info.width = attribs.value(ATTR_WIDTH).toInt();
+    info.height = attribs.value(ATTR_HEIGHT).toInt();
+    info.format = attribs.value(ATTR_FORMAT).toLatin1();
+    info.pixelFormat = static_cast<QImage::Format>(
+        qBound(0, attribs.value(ATTR_PIXELS).toInt(),
+               QImage::NImageFormats - 1));
+    info.alpha = attribs.value(ATTR_ALPHA) == QLatin1String("true");
+    // x,y,width,height or empty if the image has no content
+    const QStringList rect = attribs.value(ATTR_CONTENT).toString().split(",");
+    if (rect.size() == 4) {
+        info.content = QRect(rect.at(0).toInt(), rect.at(1).toInt(),
+                             rect.at(2).toInt(), rect.at(3).toInt());
+    }
+}
+
+static void writeImageInfo(QXmlStreamWriter &xml, const ImageInfo &info) {
+    xml.writeAttribute(ATTR_WIDTH, QString::number(info.width));
+    xml.writeAttribute(ATTR_HEIGHT, QString::number(info.height));
+    xml.writeAttribute(ATTR_FORMAT, QString::fromLatin1(info.format));
+    xml.writeAttribute(ATTR_PIXELS, QString::number(info.pixelFormat));
+    xml.writeAttribute(ATTR_ALPHA, info.alpha ? "true" : "false");
+    QString rect;
+    if (info.content.isValid()) {
+        rect = QString("%1,%2,%3,%4")
+                   .arg(info.content.x())
+                   .arg(info.content.y())
+                   .arg(info.content.width())
+                   .arg(info.content.height());
+    }
+    xml.writeAttribute(ATTR_CONTENT, rect);
+}
+
 const QStringList Cache::getAllResourceTypes() {
     return txtTypes() + binTypes();
 }
 
-Cache::Cache(const QString &cacheFolder) {
+Cache::Cache(const QString &cacheFolder) : videoConverter(cacheFolder) {
     cacheDir.setPath(cacheFolder);
     cacheDir.makeAbsolute();
     qDebug() << "Cache folder:" << cacheDir;
@@ -200,6 +245,9 @@ bool Cache::read() {
                        resource.cacheId.toStdString().c_str());
                 continue;
             }
+            if (attribs.hasAttribute(ATTR_WIDTH)) {
+                readImageInfo(attribs, resource.info);
+            }
             resource.value = xml.readElementText();
             if (binTypes().contains(resource.type) &&
                 !fileEntries.contains(cacheDir.path() % "/" % resource.value)) {
@@ -782,7 +830,8 @@ bool Cache::purgeAll(const bool unattend) {
 }
 
 bool Cache::isCommandValidOnAllPlatform(const QString &command) {
-    QList<QString> validCommands({"help", "purge:all", "vacuum", "validate"});
+    QList<QString> validCommands(
+        {"help", "purge:all", "vacuum", "validate", "backfill"});
 
     return validCommands.contains(command) ||
            command.contains("report:missing");
@@ -869,6 +918,20 @@ void Cache::validateAllPlatform(Settings config, Skyscraper *app) {
     }
 }
 
+void Cache::backfillAllPlatform(Settings config, Skyscraper *app) {
+    QDir cacheDir(config.cacheFolder);
+    for (const auto &platform :
+         cacheDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        config.platform = platform;
+        Cache cache(cacheDir.filePath(platform));
+        if (cache.read() && cache.backfill()) {
+            app->state = Skyscraper::OpMode::NO_INTR;
+            cache.write();
+            app->state = Skyscraper::OpMode::SINGLE;
+        }
+    }
+}
+
 QList<QFileInfo> Cache::getFileInfos(const QString &inputFolder,
                                      const QString &filter,
                                      const bool subdirs) {
@@ -1302,6 +1365,22 @@ void Cache::readPriorities() {
 }
 
 bool Cache::write(const bool onlyQuickId) {
+    // Finished conversions add their resources, so wait before locking
+    const int conversions = videoConverter.pendingJobs();
+    if (conversions > 0) {
+        printf("Waiting for %d video conversion(s) to finish... ",
+               conversions);
+        fflush(stdout);
+    }
+    const int failedConversions = videoConverter.waitForDone();
+    if (conversions > 0) {
+        printf("\033[1;32mDone!\033[0m\n");
+    }
+    if (failedConversions > 0) {
+        printf("\033[1;33m%d video conversion(s) failed.\033[0m\n",
+               failedConversions);
+    }
+
     QMutexLocker locker(&cacheMutex);
 
     QFile quickIdFile(quickIdFilePath());
@@ -1345,6 +1424,9 @@ bool Cache::write(const bool onlyQuickId) {
             xml.writeAttribute(ATTR_TYPE, resource.type);
             xml.writeAttribute(ATTR_SRC, resource.source);
             xml.writeAttribute(ATTR_TS, QString::number(resource.timestamp));
+            if (resource.info.isValid()) {
+                writeImageInfo(xml, resource.info);
+            }
             xml.writeCharacters(resource.value);
             xml.writeEndElement();
         }
@@ -1397,6 +1479,55 @@ void Cache::validate() {
     }
 }
 
+bool Cache::backfill() {
+    printf("Recording image information of %s platform, please wait... ",
+           cacheDir.dirName().toStdString().c_str());
+    fflush(stdout);
+
+    const QStringList imageTypes = binTypes(false, false);
+    QList<int> missing;
+    for (int a = 0; a < resources.size(); ++a) {
+        if (imageTypes.contains(resources.at(a).type) &&
+            !resources.at(a).info.isValid()) {
+            missing.append(a);
+        }
+    }
+    if (missing.isEmpty()) {
+        printf("\033[1;32mDone!\033[0m\nAll images are recorded already.\n\n");
+        return false;
+    }
+
+    // Decoded by all cores, the results are assigned afterwards to leave
+    // the resource list untouched meanwhile
+    QVector<ImageInfo> infos(missing.size());
+    TaskPool::runRanges(
+        missing.size(), 16, [this, &missing, &infos](int begin, int end) {
+            for (int a = begin; a < end; ++a) {
+                QFile f(cacheDir.path() % "/" %
+                        resources.at(missing.at(a)).value);
+                if (f.open(QIODevice::ReadOnly)) {
+                    infos[a] = ImgTools::imageInfo(f.readAll());
+                }
+            }
+        });
+
+    int recorded = 0;
+    for (int a = 0; a < missing.size(); ++a) {
+        if (infos.at(a).isValid()) {
+            resources[missing.at(a)].info = infos.at(a);
+            recorded++;
+        }
+    }
+    printf("\033[1;32mDone!\033[0m\n");
+    printf("Recorded %d of %d images.", recorded,
+           static_cast<int>(missing.size()));
+    if (recorded < missing.size()) {
+        printf(" \033[1;33mThe others couldn't be decoded.\033[0m");
+    }
+    printf("\n\n");
+    return recorded > 0;
+}
+
 void Cache::verifyFiles(QDirIterator &dirIt, int &filesDeleted,
                         int &filesNoDelete, QString resType) {
     QList<QString> resFileNames;
@@ -1544,243 +1675,213 @@ void Cache::addResources(GameEntry &entry, const Settings &config,
 void Cache::addResource(Resource &resource, GameEntry &entry,
                         const QString &cacheAbsolutePath,
                         const Settings &config, QString &output) {
+    const QString key =
+        resource.cacheId % "|" % resource.type % "|" % resource.source;
+    {
+        QMutexLocker locker(&cacheMutex);
+        // Another thread is storing the very same resource right now
+        if (pendingResources.contains(key)) {
+            return;
+        }
+        if (!config.refresh) {
+            for (const auto &res : resources) {
+                if (res.cacheId == resource.cacheId &&
+                    res.type == resource.type &&
+                    res.source == resource.source) {
+                    return;
+                }
+            }
+        }
+        pendingResources.insert(key);
+    }
+
+    // Decoding, resizing and writing happen without holding the lock, the
+    // other threads only wait for the index update. Converted videos are
+    // added by the video converter once their job is done
+    bool replaced = false;
+    bool queued = false;
+    const bool okToAppend = storeResource(
+        resource, entry, cacheAbsolutePath, config, output, replaced, queued);
+    if (!queued) {
+        commitResource(resource, replaced, okToAppend);
+    }
+}
+
+void Cache::commitResource(const Resource &resource, const bool replaced,
+                           const bool ok) {
     QMutexLocker locker(&cacheMutex);
-    bool notFound = true;
-    // This type of iterator ensures we can delete items while iterating
-    QMutableListIterator<Resource> it(resources);
-    while (it.hasNext()) {
-        Resource res = it.next();
-        if (res.cacheId == resource.cacheId && res.type == resource.type &&
-            res.source == resource.source) {
-            if (config.refresh) {
+    pendingResources.remove(resource.cacheId % "|" % resource.type % "|" %
+                            resource.source);
+    if (replaced) {
+        // This type of iterator ensures we can delete items while iterating
+        QMutableListIterator<Resource> it(resources);
+        while (it.hasNext()) {
+            const Resource &res = it.next();
+            if (res.cacheId == resource.cacheId && res.type == resource.type &&
+                res.source == resource.source) {
                 it.remove();
-            } else {
-                notFound = false;
+                break;
             }
-            break;
-        }
-    }
-
-    if (notFound) {
-        bool okToAppend = true;
-        QString cacheFile = cacheAbsolutePath + "/" + resource.value;
-        if (binTypes(false, false).contains(resource.type)) {
-            QByteArray *imageData = nullptr;
-            if (resource.type == "cover") {
-                imageData = &entry.coverData;
-            } else if (resource.type == "screenshot") {
-                imageData = &entry.screenshotData;
-            } else if (resource.type == "wheel") {
-                imageData = &entry.wheelData;
-            } else if (resource.type == "marquee") {
-                imageData = &entry.marqueeData;
-            } else if (resource.type == "texture") {
-                imageData = &entry.textureData;
-            }
-            if (config.cacheResize) {
-                QImage image;
-                if (imageData->size() > 0 && image.loadFromData(*imageData) &&
-                    !image.isNull()) {
-                    int max = 800;
-                    if (image.width() > max || image.height() > max) {
-                        image = image.scaled(max, max, Qt::KeepAspectRatio,
-                                             Qt::SmoothTransformation);
-                    }
-                    QByteArray resizedData;
-                    QBuffer b(&resizedData);
-                    b.open(QIODevice::WriteOnly);
-                    if ((image.hasAlphaChannel() && hasAlpha(image)) ||
-                        resource.type == "screenshot") {
-                        okToAppend = image.save(&b, "png");
-                    } else {
-                        okToAppend = image.save(&b, "jpg", config.jpgQuality);
-                    }
-                    b.close();
-                    if (imageData->size() > resizedData.size()) {
-                        if (config.verbosity >= 3) {
-                            printf("%s: '%d' > '%d', choosing resize for "
-                                   "optimal result!\n",
-                                   resource.type.toStdString().c_str(),
-                                   static_cast<int>(imageData->size()),
-                                   static_cast<int>(resizedData.size()));
-                        }
-                        *imageData = resizedData;
-                    }
-                } else {
-                    okToAppend = false;
+        }
+    }
+    if (ok) {
+        resources.append(resource);
+    } else {
+        printf("\033[1;33mWarning! Couldn't add resource to cache. Have "
+               "you run out of disk space?\n\033[0m");
+    }
+}
+
+// Writes the data of resource to the cache folder. Files are only replaced
+// once complete, so a failure keeps the file of an entry being refreshed.
+// replaced tells whether an existing entry of the resource is outdated now,
+// queued that a video conversion commits the resource later on
+bool Cache::storeResource(Resource &resource, GameEntry &entry,
+                          const QString &cacheAbsolutePath,
+                          const Settings &config, QString &output,
+                          bool &replaced, bool &queued) {
+    bool okToAppend = true;
+    QString cacheFile = cacheAbsolutePath + "/" + resource.value;
+    // The caller may reuse resource for several types
+    resource.info = ImageInfo();
+    if (binTypes(false, false).contains(resource.type)) {
+        QByteArray *imageData = nullptr;
+        if (resource.type == "cover") {
+            imageData = &entry.coverData;
+        } else if (resource.type == "screenshot") {
+            imageData = &entry.screenshotData;
+        } else if (resource.type == "wheel") {
+            imageData = &entry.wheelData;
+        } else if (resource.type == "marquee") {
+            imageData = &entry.marqueeData;
+        } else if (resource.type == "texture") {
+            imageData = &entry.textureData;
+        }
+        if (config.cacheResize) {
+            QImage image;
+            if (imageData->size() > 0 && image.loadFromData(*imageData) &&
+                !image.isNull()) {
+                int max = 800;
+                if (image.width() > max || image.height() > max) {
+                    image = image.scaled(max, max, Qt::KeepAspectRatio,
+                                         Qt::SmoothTransformation);
                 }
-            }
-            if (okToAppend) {
-                QFile f(cacheFile);
-                if (f.open(QIODevice::WriteOnly)) {
-                    f.write(*imageData);
-                    f.close();
+                QByteArray resizedData;
+                QBuffer b(&resizedData);
+                b.open(QIODevice::WriteOnly);
+                if (ImgTools::hasAlpha(image) ||
+                    resource.type == "screenshot") {
+                    okToAppend = image.save(&b, "png");
                 } else {
-                    output.append("Error writing file: '" + f.fileName() +
-                                  "' to cache. Please check permissions.");
-                    okToAppend = false;
+                    okToAppend = image.save(&b, "jpg", config.jpgQuality);
                 }
-            } else {
-                // Image was faulty and could not be saved to cache so we clear
-                // the QByteArray data in game entry to make sure we get a "NO"
-                // in the terminal output from scraperworker.cpp.
-                imageData->clear();
-            }
-        } else if (resource.type == "video") {
-            if (entry.videoData.size() <= config.videoSizeLimit) {
-                QFile f(cacheFile);
-                if (f.open(QIODevice::WriteOnly)) {
-                    f.write(entry.videoData);
-                    f.close();
-                    if (!config.videoConvertCommand.isEmpty()) {
-                        output.append("Video conversion: ");
-                        if (doVideoConvert(resource, cacheFile,
-                                           cacheAbsolutePath, config, output)) {
-                            output.append("\033[1;32mSuccess!\033[0m");
-                        } else {
-                            output.append(
-                                "\033[1;31mFailed!\033[0m (set higher "
-                                "'--verbosity N' level for more info)");
-                            f.remove();
-                            okToAppend = false;
-                        }
+                b.close();
+                if (imageData->size() > resizedData.size()) {
+                    if (config.verbosity >= 3) {
+                        printf("%s: '%d' > '%d', choosing resize for "
+                               "optimal result!\n",
+                               resource.type.toStdString().c_str(),
+                               static_cast<int>(imageData->size()),
+                               static_cast<int>(resizedData.size()));
                     }
-                } else {
-                    output.append("Error writing file: '" + f.fileName() +
-                                  "' to cache. Please check permissions.");
-                    okToAppend = false;
+                    *imageData = resizedData;
                 }
             } else {
-                output.append(
-                    "Video exceeds maximum size of " +
-                    QString::number(config.videoSizeLimit / 1000 / 1000) +
-                    " MB. Adjust this limit with the 'videoSizeLimit' variable "
-                    "in '" %
-                        Config::getSkyFolder(Config::SkyFolderType::CONFIG) %
-                        "/config.ini.'");
                 okToAppend = false;
             }
-        } else if (resource.type == "manual") {
-            QFile f(cacheFile);
+        }
+        if (okToAppend) {
+            QSaveFile f(cacheFile);
             if (f.open(QIODevice::WriteOnly)) {
-                f.write(entry.manualData);
-                f.close();
-            } else {
+                f.write(*imageData);
+            }
+            if (!f.commit()) {
                 output.append("Error writing file: '" + f.fileName() +
                               "' to cache. Please check permissions.");
                 okToAppend = false;
+            } else {
+                // Decoded once here, so the compositor needn't scan for
+                // the content of the image again and again
+                resource.info = ImgTools::imageInfo(*imageData);
             }
-        }
-
-        if (okToAppend) {
-            if (binTypes(false, false).contains(resource.type)) {
-                // Remove old style cache image if it exists
-                if (QFile::exists(cacheFile + ".png")) {
-                    QFile::remove(cacheFile + ".png");
-                }
+        } else {
+            // Image was faulty and could not be saved to cache so we clear
+            // the QByteArray data in game entry to make sure we get a "NO"
+            // in the terminal output from scraperworker.cpp.
+            imageData->clear();
+        }
+    } else if (resource.type == "video") {
+        if (entry.videoData.size() > config.videoSizeLimit) {
+            output.append(
+                "Video exceeds maximum size of " +
+                QString::number(config.videoSizeLimit / 1000 / 1000) +
+                " MB. Adjust this limit with the 'videoSizeLimit' variable "
+                "in '" %
+                    Config::getSkyFolder(Config::SkyFolderType::CONFIG) %
+                    "/config.ini.'");
+            okToAppend = false;
+        } else if (config.videoConvertCommand.isEmpty()) {
+            QSaveFile f(cacheFile);
+            if (f.open(QIODevice::WriteOnly)) {
+                f.write(entry.videoData);
+            }
+            if (!f.commit()) {
+                output.append("Error writing file: '" + f.fileName() +
+                              "' to cache. Please check permissions.");
+                okToAppend = false;
             }
-            resources.append(resource);
         } else {
-            printf("\033[1;33mWarning! Couldn't add resource to cache. Have "
-                   "you run out of disk space?\n\033[0m");
-        }
-    }
-}
-
-bool Cache::doVideoConvert(Resource &resource, QString &cacheFile,
-                           const QString &cacheAbsolutePath,
-                           const Settings &config, QString &output) {
-    if (config.verbosity >= 2) {
-        output.append("\n");
-    }
-    QString videoConvertCommand = config.videoConvertCommand;
-    if (!videoConvertCommand.contains("%i")) {
-        output.append(
-            "'videoConvertCommand' is missing the required %i tag.\n");
-        return false;
-    }
-    if (!videoConvertCommand.contains("%o")) {
-        output.append(
-            "'videoConvertCommand' is missing the required %o tag.\n");
-        return false;
-    }
-    QFileInfo cacheFileInfo(cacheFile);
-    QString tmpCacheFile = cacheFileInfo.absolutePath() + "/tmpfile_" +
-                           (config.videoConvertExtension.isEmpty()
-                                ? cacheFileInfo.fileName()
-                                : cacheFileInfo.completeBaseName() + "." +
-                                      config.videoConvertExtension);
-    videoConvertCommand.replace("%i", cacheFile);
-    videoConvertCommand.replace("%o", tmpCacheFile);
-    if (QFile::exists(tmpCacheFile)) {
-        if (!QFile::remove(tmpCacheFile)) {
-            output.append("'" + tmpCacheFile +
-                          "' already exists and can't be removed.\n");
-            return false;
-        }
-    }
-    if (config.verbosity >= 2) {
-        output.append("%i: '" + cacheFile + "'\n");
-        output.append("%o: '" + tmpCacheFile + "'\n");
-    }
-    if (config.verbosity >= 3) {
-        output.append("Running command: '" + videoConvertCommand + "'\n");
-    }
-    QProcess convertProcess;
-    if (videoConvertCommand.contains(" ")) {
-        convertProcess.start(
-            videoConvertCommand.split(' ').first(),
-            QStringList({videoConvertCommand.split(' ').mid(1)}));
-    } else {
-        convertProcess.start(videoConvertCommand, QStringList({}));
-    }
-    // Wait 10 minutes max for conversion to complete
-    if (convertProcess.waitForFinished(1000 * 60 * 10) &&
-        convertProcess.exitStatus() == QProcess::NormalExit &&
-        QFile::exists(tmpCacheFile)) {
-        if (!QFile::remove(cacheFile)) {
-            output.append("Original '" + cacheFile +
-                          "' file couldn't be removed.\n");
-            return false;
-        }
-        cacheFile = tmpCacheFile;
-        cacheFile.replace("tmpfile_", "");
-        if (QFile::exists(cacheFile)) {
-            if (!QFile::remove(cacheFile)) {
-                output.append("'" + cacheFile +
-                              "' already exists and can't be removed.\n");
-                return false;
+            const Resource converting = resource;
+            auto done = [this, converting, cacheAbsolutePath](
+                            bool ok, const QString &file) {
+                Resource res = converting;
+                res.value = file.mid(cacheAbsolutePath.length() + 1);
+                // The converted file takes the place of an existing entry
+                commitResource(res, true, ok);
+            };
+            output.append("Video conversion: ");
+            switch (videoConverter.convert(entry.videoData, cacheFile, config,
+                                           output, done)) {
+            case VideoConverter::QUEUED:
+                output.append(
+                    "\033[1;33mQueued\033[0m (" +
+                    QString::number(videoConverter.pendingJobs()) +
+                    " pending)");
+                queued = true;
+                break;
+            case VideoConverter::REUSED:
+                output.append("\033[1;32mReused earlier result!\033[0m");
+                resource.value = cacheFile.mid(cacheAbsolutePath.length() + 1);
+                break;
+            case VideoConverter::FAILED:
+                output.append("\033[1;31mFailed!\033[0m (set higher "
+                              "'--verbosity N' level for more info)");
+                okToAppend = false;
+                break;
             }
         }
-        if (QFile::rename(tmpCacheFile, cacheFile)) {
-            resource.value = cacheFile.replace(cacheAbsolutePath + "/", "");
-        } else {
-            output.append("Couldn't rename file '" + tmpCacheFile + "' to '" +
-                          cacheFile + "', please check permissions!\n");
-            return false;
+    } else if (resource.type == "manual") {
+        QSaveFile f(cacheFile);
+        if (f.open(QIODevice::WriteOnly)) {
+            f.write(entry.manualData);
         }
-    } else {
-        if (config.verbosity >= 3) {
-            output.append(convertProcess.readAllStandardOutput() + "\n");
-            output.append(convertProcess.readAllStandardError() + "\n");
+        if (!f.commit()) {
+            output.append("Error writing file: '" + f.fileName() +
+                          "' to cache. Please check permissions.");
+            okToAppend = false;
         }
-        return false;
-    }
-    if (config.verbosity >= 3) {
-        output.append(convertProcess.readAllStandardOutput() + "\n");
-        output.append(convertProcess.readAllStandardError() + "\n");
     }
-    return true;
-}
 
-bool Cache::hasAlpha(const QImage &image) {
-    QRgb *constBits = (QRgb *)image.constBits();
-    for (int a = 0; a < image.width() * image.height(); ++a) {
-        if (qAlpha(constBits[a]) < 127) {
-            return true;
+    if (okToAppend && binTypes(false, false).contains(resource.type)) {
+        // Remove old style cache image if it exists
+        if (QFile::exists(cacheFile + ".png")) {
+            QFile::remove(cacheFile + ".png");
         }
     }
-    return false;
+    if (okToAppend) {
+        replaced = true;
+    }
+    return okToAppend;
 }
 
 void Cache::addQuickId(const QFileInfo &info, const QString &cacheId) {
@@ -1867,9 +1968,35 @@ void Cache::fillBlanks(GameEntry &entry, const QString scraper) {
         QByteArray data;
         if (fillType(type, matchingResources, result, source)) {
             QFile f(cacheDir.path() + "/" + result);
+            if (type == "video" || type == "manual") {
+                // Not part of artwork.xml / compositor.cpp and exported by
+                // their file, see ScraperWorker::copyMedia. Never read
+                if (f.size() == 0) {
+                    continue;
+                }
+                QFileInfo info(f);
+                if (type == "video") {
+                    entry.videoSrc = source;
+                    entry.videoFormat = info.suffix();
+                    entry.videoFile = info.absoluteFilePath();
+                } else {
+                    entry.manualSrc = source;
+                    entry.manualFile = info.absoluteFilePath();
+                }
+                continue;
+            }
             if (f.open(QIODevice::ReadOnly)) {
                 data = f.readAll();
                 f.close();
+                entry.cacheFiles.insert(type,
+                                        QFileInfo(f).absoluteFilePath());
+                for (const auto &resource : matchingResources) {
+                    if (resource.type == type && resource.value == result &&
+                        resource.source == source) {
+                        entry.imageInfos.insert(type, resource.info);
+                        break;
+                    }
+                }
             }
             if (type == "cover") {
                 entry.coverData = data;
@@ -1886,21 +2013,6 @@ void Cache::fillBlanks(GameEntry &entry, const QString scraper) {
             } else if (type == "texture") {
                 entry.textureData = data;
                 entry.textureSrc = source;
-            } else if (type == "video" && !data.isEmpty()) {
-                // video is not part of artwork.xml / compositor.cpp
-                // set filename here
-                entry.videoData = data;
-                entry.videoSrc = source;
-                QFileInfo info(f);
-                entry.videoFormat = info.suffix();
-                entry.videoFile = info.absoluteFilePath();
-            } else if (type == "manual" && !data.isEmpty()) {
-                // manual is not part of artwork.xml / compositor.cpp
-                // set filename here
-                entry.manualData = data;
-                entry.manualSrc = source;
-                QFileInfo info(f);
-                entry.manualFile = info.absoluteFilePath();
             }
             // PENDING: if thumbnail is ever used add it here like video/manual
         }
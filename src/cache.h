@@ -27,13 +27,16 @@
 #define CACHE_H
 
 #include "gameentry.h"
+#include "imgtools.h"
 #include "queue.h"
 #include "settings.h"
+#include "videoconverter.h"
 
 #include <QDirIterator>
 #include <QMap>
 #include <QMutex>
 #include <QObject>
+#include <QSet>
 #include <QSharedPointer>
 #include <QString>
 
@@ -46,6 +49,8 @@ struct Resource {
     QString source = "";
     QString value = "";
     qint64 timestamp = 0;
+    // Image resources only, recorded when they are stored
+    ImageInfo info;
 };
 
 struct ResCounts {
@@ -77,6 +82,7 @@ public:
     static void reportAllPlatform(Settings config, Skyscraper *app);
     static void vacuumAllPlatform(Settings config, Skyscraper *app);
     static void validateAllPlatform(Settings config, Skyscraper *app);
+    static void backfillAllPlatform(Settings config, Skyscraper *app);
 
     static const QStringList getAllResourceTypes();
     bool createFolders(const QString &scraper);
@@ -93,6 +99,8 @@ public:
     void readPriorities();
     bool write(const bool onlyQuickId = false);
     void validate();
+    // Records the ImageInfo of image resources cached without it
+    bool backfill();
     void addResources(GameEntry &entry, const Settings &config,
                       QString &output);
     void fillBlanks(GameEntry &entry, const QString scraper = "");
@@ -113,11 +121,16 @@ private:
     QMap<QString, ResCounts> resCountsMap;
 
     QList<Resource> resources;
+    // cacheId, type and source of resources being stored outside the lock
+    QSet<QString> pendingResources;
     QMap<QString, QPair<qint64, QString>>
         quickIds; // filePath, timestamp + cacheId for quick lookup
 
     int resAtLoad = 0;
 
+    // Declared last, its jobs still add resources until it is destroyed
+    VideoConverter videoConverter;
+
     QList<QFileInfo> getFileInfos(const QString &inputFolder,
                                   const QString &filter,
                                   const bool subdirs = true);
@@ -127,16 +140,18 @@ private:
     void addResource(Resource &resource, GameEntry &entry,
                      const QString &cacheAbsolutePath, const Settings &config,
                      QString &output);
+    bool storeResource(Resource &resource, GameEntry &entry,
+                       const QString &cacheAbsolutePath,
+                       const Settings &config, QString &output,
+                       bool &replaced, bool &queued);
+    void commitResource(const Resource &resource, const bool replaced,
+                        const bool ok);
     void verifyFiles(QDirIterator &dirIt, int &filesDeleted, int &noDelete,
                      QString resType);
     void verifyResources(int &resourcesDeleted);
     bool removeMediaFile(Resource &res, const char *msg);
     bool fillType(const QString &type, QList<Resource> &matchingResources,
                   QString &result, QString &source);
-    bool doVideoConvert(Resource &resource, QString &cacheFile,
-                        const QString &cacheAbsolutePath,
-                        const Settings &config, QString &output);
-    bool hasAlpha(const QImage &image);
     void printStats(bool totals);
     void printCacheEditMenu();
 
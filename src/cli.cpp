@@ -330,6 +330,10 @@ QMap<QString, QString> Cli::getSubCommandOpts(const QString subCmd) {
                      "platform."},
             {"validate",
              "Checks the consistency of the cache for the selected platform."},
+            {"backfill",
+             "Records size, format and transparency of images cached by "
+             "Skyscraper versions before 3.18.0. The artwork compositing "
+             "uses these to skip work."},
             {"edit",
              "Let's you edit resources for the selected platform for all files "
              "or a range of files. Add a filename on command line to edit "
@@ -25,6 +25,7 @@
 
 #include "compositor.h"
 
+#include "fileexport.h"
 #include "fxbalance.h"
 #include "fxblur.h"
 #include "fxbrightness.h"
@@ -33,6 +34,7 @@
 #include "fxframe.h"
 #include "fxgamebox.h"
 #include "fxhue.h"
+#include "fxkernels.h"
 #include "fxmask.h"
 #include "fxopacity.h"
 #include "fxrotate.h"
@@ -42,22 +44,54 @@
 #include "fxshadow.h"
 #include "fxstroke.h"
 #include "gameentry.h"
+#include "imagewriter.h"
 #include "imgtools.h"
 #include "strtools.h"
+#include "taskpool.h"
 
+#include <QBuffer>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
 #include <QDomDocument>
 #include <QFileInfo>
+#include <QImageReader>
+#include <QMutexLocker>
 #include <QPainter>
+#include <QSaveFile>
 #include <QSettings>
 #include <QStringBuilder>
+#include <QTextStream>
+#include <QVector>
 #include <cmath>
+#include <functional>
+#include <utility>
+
+// Game images in the order of their slots, starting at R_COVER
+static const QStringList GAMEIMAGES = {"cover", "screenshot", "wheel",
+                                       "marquee", "texture"};
+
+QMutex Compositor::plansMutex;
+QMap<QString, QSharedPointer<const Layer>> Compositor::plans;
+
+QMutex Compositor::manifestMutex;
+QString Compositor::manifestFile;
+QMap<QString, QByteArray> Compositor::manifest;
+bool Compositor::manifestChanged = false;
 
 Compositor::Compositor(Settings *config) { this->config = config; }
 
 bool Compositor::processXml() {
-    Layer newOutputs;
+    // The plan depends on the xml and on which resources could be loaded,
+    // all scraping threads share it
+    QStringList resourceNames = config->resources.keys();
+    const QString key =
+        config->artworkXml + "\n" + resourceNames.join(QChar('\n'));
+    QMutexLocker locker(&plansMutex);
+    if (plans.contains(key)) {
+        outputs = plans.value(key);
+        return true;
+    }
 
     // Check document for errors before running through it
     QDomDocument doc;
@@ -67,10 +101,13 @@ bool Compositor::processXml() {
     QXmlStreamReader xml(config->artworkXml);
 
     // Init recursive parsing
+    Layer newOutputs;
     addChildLayers(newOutputs, xml);
+    compileLayers(newOutputs);
+    digestOutputs(newOutputs, doc);
 
-    // Assign global outputs to these new outputs
-    outputs = newOutputs;
+    outputs = QSharedPointer<const Layer>(new Layer(newOutputs));
+    plans.insert(key, outputs);
     return true;
 }
 
@@ -102,6 +139,13 @@ void Compositor::addChildLayers(Layer &layer, QXmlStreamReader &xml) {
                 if (attribs.hasAttribute("transform"))
                     newLayer.setTransform(
                         attribs.value("transform").toString());
+                if (attribs.hasAttribute("format"))
+                    newLayer.setFormat(attribs.value("format").toString());
+                if (attribs.hasAttribute("compression"))
+                    newLayer.setCompression(
+                        attribs.value("compression").toInt());
+                if (attribs.hasAttribute("quality"))
+                    newLayer.setQuality(attribs.value("quality").toInt());
 
                 if (newLayer.type != T_NONE) {
                     addChildLayers(newLayer, xml);
@@ -144,10 +188,14 @@ void Compositor::addChildLayers(Layer &layer, QXmlStreamReader &xml) {
                 newLayer.setDistance(attribs.value("distance").toInt());
                 newLayer.setSoftness(attribs.value("softness").toInt());
                 newLayer.setOpacity(attribs.value("opacity").toInt());
+                if (attribs.hasAttribute("kernel"))
+                    newLayer.setKernel(attribs.value("kernel").toString());
                 layer.addLayer(newLayer);
             } else if (elemName == "blur" && attribs.hasAttribute("softness")) {
                 newLayer.setType(T_BLUR);
                 newLayer.setSoftness(attribs.value("softness").toInt());
+                if (attribs.hasAttribute("kernel"))
+                    newLayer.setKernel(attribs.value("kernel").toString());
                 layer.addLayer(newLayer);
             } else if (elemName == "mask" && attribs.hasAttribute("file")) {
                 newLayer.setType(T_MASK);
@@ -190,6 +238,9 @@ void Compositor::addChildLayers(Layer &layer, QXmlStreamReader &xml) {
                     if (attribs.hasAttribute("blue"))
                         newLayer.setBlue(attribs.value("blue").toInt());
                 }
+                if (attribs.hasAttribute("antialias"))
+                    newLayer.setAntialias(attribs.value("antialias") ==
+                                          QString("true"));
                 layer.addLayer(newLayer);
             } else if (elemName == "rounded" &&
                        attribs.hasAttribute("radius")) {
@@ -276,17 +327,288 @@ void Compositor::addChildLayers(Layer &layer, QXmlStreamReader &xml) {
     }
 }
 
+void Compositor::compileLayers(Layer &layer) {
+    QList<Layer> compiled;
+    // Consecutive per channel effects collapse into one table lookup
+    QList<Layer> run;
+    auto flush = [&compiled, &run]() {
+        if (run.size() == 1) {
+            compiled.append(run.first());
+        } else if (run.size() > 1) {
+            Layer fused;
+            fused.setType(T_LUT);
+            fused.lut = fuseEffects(run);
+            compiled.append(fused);
+        }
+        run.clear();
+    };
+    for (Layer child : layer.getLayers()) {
+        resolveLayer(child);
+        if (child.type == T_OUTPUT || child.type == T_LAYER) {
+            compileLayers(child);
+        }
+        if (isDead(child)) {
+            continue;
+        }
+        if (isPerChannel(child)) {
+            run.append(child);
+            continue;
+        }
+        flush();
+        compiled.append(child);
+    }
+    flush();
+    layer.setLayers(compiled);
+}
+
+void Compositor::resolveLayer(Layer &layer) {
+    const int gameImage = GAMEIMAGES.indexOf(layer.resource);
+    if (gameImage != -1) {
+        layer.slot = R_COVER + gameImage;
+    } else if (layer.type == T_OUTPUT || layer.resource.isEmpty()) {
+        // Outputs only take game images
+        layer.slot = R_NONE;
+    } else {
+        layer.slot = R_STATIC;
+    }
+
+    if (layer.type == T_OUTPUT && !ImageWriter::isSupported(layer.format)) {
+        printf("\033[1;33mImage format '%s' of output '%s' is not supported "
+               "by this Qt installation, using 'png' instead.\033[0m\n",
+               layer.format.constData(), layer.resType.toUtf8().constData());
+        layer.format = "png";
+    }
+
+    if (layer.align == "center") {
+        layer.hAlign = A_CENTER;
+    } else if (layer.align == "right") {
+        layer.hAlign = A_END;
+    }
+    if (layer.valign == "middle") {
+        layer.vAlign = A_CENTER;
+    } else if (layer.valign == "bottom") {
+        layer.vAlign = A_END;
+    }
+}
+
+bool Compositor::isDead(const Layer &layer) {
+    switch (layer.type) {
+    case T_LAYER: {
+        if (layer.slot == R_STATIC &&
+            config->resources.value(layer.resource).isNull()) {
+            // Never gets a canvas, neither do its children
+            return true;
+        }
+        if (layer.mode != QPainter::CompositionMode_SourceOver) {
+            return false;
+        }
+        // Paints nothing over the parent
+        return layer.opacity == 0 ||
+               (layer.slot == R_NONE && !layer.hasLayers());
+    }
+    case T_BRIGHTNESS:
+    case T_CONTRAST:
+        return layer.delta == 0;
+    case T_BALANCE:
+        return layer.red == 0 && layer.green == 0 && layer.blue == 0;
+    case T_OPACITY:
+        return layer.opacity == 100;
+    default:
+        return false;
+    }
+}
+
+bool Compositor::isPerChannel(const Layer &layer) {
+    return layer.type == T_BRIGHTNESS || layer.type == T_CONTRAST ||
+           layer.type == T_BALANCE || layer.type == T_OPACITY;
+}
+
+QImage Compositor::applyPerChannel(QImage canvas, const Layer &layer) {
+    switch (layer.type) {
+    case T_BRIGHTNESS:
+        return FxBrightness().applyEffect(std::move(canvas), layer);
+    case T_CONTRAST:
+        return FxContrast().applyEffect(std::move(canvas), layer);
+    case T_BALANCE:
+        return FxBalance().applyEffect(std::move(canvas), layer);
+    case T_OPACITY:
+        return FxOpacity().applyEffect(std::move(canvas), layer);
+    default:
+        return canvas;
+    }
+}
+
+QImage Compositor::fuseEffects(const QList<Layer> &effects) {
+    // Run the effects once on every premultiplied (value, alpha) pair. As
+    // each channel only depends on itself and alpha, looking the channels
+    // of a pixel up in the result gives exactly the same as running the
+    // effects on it one after another
+    QImage lut(256, 256, QImage::Format_ARGB32_Premultiplied);
+    for (int a = 0; a < 256; ++a) {
+        QRgb *line = (QRgb *)lut.scanLine(a);
+        for (int p = 0; p < 256; ++p) {
+            const int v = qMin(p, a);
+            line[p] = qRgba(v, v, v, a);
+        }
+    }
+    for (const auto &effect : effects) {
+        lut = applyPerChannel(std::move(lut), effect);
+    }
+    return lut;
+}
+
+void Compositor::digestOutputs(Layer &layer, const QDomDocument &doc) {
+    // Output nodes in document order, as addChildLayers() finds them
+    QStringList subtrees;
+    const QDomNodeList nodes = doc.elementsByTagName("output");
+    for (int a = 0; a < nodes.size(); ++a) {
+        const QDomElement elem = nodes.at(a).toElement();
+        if (elem.hasAttribute("type")) {
+            QString subtree;
+            QTextStream stream(&subtree);
+            elem.save(stream, 0);
+            subtrees.append(subtree);
+        }
+    }
+
+    QList<Layer> outputLayers = layer.getLayers();
+    for (int a = 0; a < outputLayers.size(); ++a) {
+        Layer &output = outputLayers[a];
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        // The rendering may change between versions
+        hash.addData(QByteArray(VERSION));
+        hash.addData(QByteArray(config->cropBlack ? "1" : "0"));
+        hash.addData(config->artworkPassthrough.toUtf8());
+        hash.addData(QByteArray::number(config->artworkPixelBudget));
+        // Should the outputs not line up, any change of the xml counts
+        hash.addData(subtrees.size() == outputLayers.size()
+                         ? subtrees.at(a).toUtf8()
+                         : config->artworkXml.toUtf8());
+        QStringList names;
+        collectResources(output, names);
+        names.removeDuplicates();
+        names.sort();
+        for (const auto &name : names) {
+            const QImage image = config->resources.value(name);
+            hash.addData(name.toUtf8());
+            hash.addData(QByteArray::fromRawData(
+                (const char *)image.constBits(), image.sizeInBytes()));
+        }
+        output.digest = hash.result();
+        output.inputs = (output.slot >= R_COVER ? 1 << output.slot : 0) |
+                        collectInputs(output);
+    }
+    layer.setLayers(outputLayers);
+}
+
+void Compositor::collectResources(const Layer &layer, QStringList &names) {
+    for (const auto &child : layer.getLayers()) {
+        // Layers as well as the files of masks, frames and the like
+        if (child.slot == R_STATIC) {
+            names.append(child.resource);
+        }
+        // Defaults of the effects, see FxGamebox and FxScanlines
+        if (child.type == T_GAMEBOX) {
+            names.append({"boxfront.png", "boxside.png"});
+        } else if (child.type == T_SCANLINES) {
+            names.append("scanlines1.png");
+        }
+        collectResources(child, names);
+    }
+}
+
+int Compositor::collectInputs(const Layer &layer) {
+    int inputs = 0;
+    for (const auto &child : layer.getLayers()) {
+        if (child.slot >= R_COVER) {
+            inputs |= 1 << child.slot;
+        }
+        inputs |= collectInputs(child);
+    }
+    return inputs;
+}
+
+QByteArray Compositor::gameDigest(const GameEntry &game,
+                                  const Layer &output) {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(output.digest);
+    for (int slot = R_COVER; slot <= R_TEXTURE; ++slot) {
+        if (output.inputs & (1 << slot)) {
+            const QByteArray data = gameData(game, slot);
+            hash.addData(QByteArray::number(data.size()));
+            hash.addData(data);
+        }
+    }
+    return hash.result();
+}
+
+bool Compositor::isUpToDate(const QString &filename,
+                            const QByteArray &digest) {
+    QMutexLocker locker(&manifestMutex);
+    if (manifestFile.isNull() && !config->mediaFolder.isEmpty()) {
+        manifestFile = config->mediaFolder % "/.skyscraper-manifest";
+        QFile file(manifestFile);
+        if (file.open(QIODevice::ReadOnly)) {
+            while (!file.atEnd()) {
+                const QByteArray line = file.readLine().trimmed();
+                const int tab = line.indexOf('\t');
+                if (tab > 0) {
+                    manifest.insert(QString::fromUtf8(line.mid(tab + 1)),
+                                    QByteArray::fromHex(line.left(tab)));
+                }
+            }
+            file.close();
+        }
+    }
+    return manifest.value(filename) == digest && QFileInfo::exists(filename);
+}
+
+void Compositor::updateManifest(const QString &filename,
+                                const QByteArray &digest) {
+    QMutexLocker locker(&manifestMutex);
+    if (manifest.value(filename) != digest) {
+        manifest.insert(filename, digest);
+        manifestChanged = true;
+    }
+}
+
+void Compositor::writeManifest() {
+    QMutexLocker locker(&manifestMutex);
+    if (!manifestChanged || manifestFile.isEmpty()) {
+        return;
+    }
+    QSaveFile file(manifestFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write" << manifestFile;
+        return;
+    }
+    for (auto it = manifest.constBegin(); it != manifest.constEnd(); ++it) {
+        file.write(it.value().toHex() % '\t' % it.key().toUtf8() % '\n');
+    }
+    if (file.commit()) {
+        manifestChanged = false;
+    }
+}
+
 void Compositor::saveAll(GameEntry &game, QString completeBaseName) {
     bool createSubfolder = false;
-    QString fn = "/" % completeBaseName % ".png";
+    QString fn = "/" % completeBaseName;
     QString subPath = getSubpath(game.path);
     if (subPath != ".") {
         fn.prepend("/" % subPath);
         createSubfolder = true;
     }
 
-    for (auto &output : outputs.getLayers()) {
-        QString filename = fn;
+    gameImages.fill(QImage(), R_TEXTURE + 1);
+    gameImagesDecoded.fill(false, R_TEXTURE + 1);
+    const QList<Layer> &outputLayers = outputs->getLayers();
+    QVector<QString> filenames(outputLayers.size());
+    QVector<bool> saved(outputLayers.size(), false);
+    QList<std::function<void()>> tasks;
+    for (int a = 0; a < outputLayers.size(); ++a) {
+        const Layer &output = outputLayers.at(a);
+        bool *outputSaved = &saved[a];
+        QString filename = fn % "." % output.format;
         if (output.resType == "cover") {
             filename.prepend(config->coversFolder);
             if (config->skipExistingCovers && QFileInfo::exists(filename)) {
@@ -319,189 +641,379 @@ void Compositor::saveAll(GameEntry &game, QString completeBaseName) {
                 continue;
             }
         }
+        filenames[a] = filename;
 
-        if (output.resource == "cover") {
-            output.setCanvas(QImage::fromData(game.coverData));
-        } else if (output.resource == "screenshot") {
-            output.setCanvas(QImage::fromData(game.screenshotData));
-        } else if (output.resource == "wheel") {
-            output.setCanvas(QImage::fromData(game.wheelData));
-        } else if (output.resource == "marquee") {
-            output.setCanvas(QImage::fromData(game.marqueeData));
-        } else if (output.resource == "texture") {
-            output.setCanvas(QImage::fromData(game.textureData));
+        // Inputs didn't change since the file was written
+        const QByteArray digest = gameDigest(game, output);
+        if (isUpToDate(filename, digest)) {
+            saved[a] = true;
+            continue;
         }
 
-        if (output.canvas.isNull() && output.hasLayers()) {
-            QImage tmpImage(10, 10, QImage::Format_ARGB32_Premultiplied);
-            output.setCanvas(tmpImage);
-        }
+        // Outputs don't depend on each other, render them concurrently
+        tasks.append([this, &game, &output, outputSaved, filename, digest,
+                      createSubfolder]() {
+            if (createSubfolder) {
+                QFileInfo fi = QFileInfo(filename);
+                if (!QDir().mkpath(fi.absolutePath())) {
+                    qWarning()
+                        << "Path could not be created" << fi.absolutePath()
+                        << " Check file permissions, gamelist binary data "
+                           "maybe incomplete.";
+                }
+            }
+
+            const QString source = passThroughFile(game, output);
+            if (!source.isEmpty()) {
+                *outputSaved =
+                    FileExport::place(source, filename,
+                                      config->artworkPassthrough == "link"
+                                          ? FileExport::HARDLINK
+                                          : FileExport::COPY) !=
+                    FileExport::FAILED;
+                if (*outputSaved) {
+                    updateManifest(filename, digest);
+                    return;
+                }
+                // Render it then
+            }
 
-        output.premultiply();
-        output.scale();
+            Canvas canvas;
+            canvas.image = getGameImage(game, output.slot);
 
-        if (output.hasLayers()) {
-            // Reset output.canvas since composite layers exist
-            output.makeTransparent();
-            // Initiate recursive compositing
-            processChildLayers(game, output);
-        }
+            if (canvas.image.isNull() && output.hasLayers()) {
+                canvas.image =
+                    QImage(10, 10, QImage::Format_ARGB32_Premultiplied);
+            }
+
+            canvas.image = output.scale(canvas.image.convertToFormat(
+                QImage::Format_ARGB32_Premultiplied));
+            // Children are aligned with the size given in the xml
+            canvas.width = output.width;
+            canvas.height = output.height;
 
-        if (createSubfolder) {
-            QFileInfo fi = QFileInfo(filename);
-            if (!QDir().mkpath(fi.absolutePath())) {
-                qWarning() << "Path could not be created" << fi.absolutePath()
-                           << " Check file permissions, gamelist binary data "
-                              "maybe incomplete.";
+            if (output.hasLayers()) {
+                // Reset the canvas since composite layers exist
+                canvas.image.fill(Qt::transparent);
+                // Initiate recursive compositing
+                processChildLayers(game, output, canvas);
             }
+
+            // The manifest only learns about files that made it to disk
+            const auto written = [filename, digest](bool ok) {
+                if (ok) {
+                    updateManifest(filename, digest);
+                }
+            };
+            *outputSaved =
+                output.save(std::move(canvas.image), filename, written);
+        });
+    }
+    if (config->artworkPixelBudget > 0) {
+        // One canvas at a time
+        for (const auto &task : tasks) {
+            task();
         }
+    } else {
+        TaskPool::run(tasks);
+    }
 
-        if (output.resType == "cover" && output.save(filename)) {
-            game.coverFile = filename;
-        } else if (output.resType == "screenshot" && output.save(filename)) {
-            game.screenshotFile = filename;
-        } else if (output.resType == "wheel" && output.save(filename)) {
-            game.wheelFile = filename;
-        } else if (output.resType == "marquee" && output.save(filename)) {
-            game.marqueeFile = filename;
-        } else if (output.resType == "texture" && output.save(filename)) {
-            game.textureFile = filename;
+    // Assign in order of the outputs, so the last of several outputs of the
+    // same type wins as before
+    for (int a = 0; a < outputLayers.size(); ++a) {
+        if (!saved.at(a)) {
+            continue;
+        }
+        const QString &resType = outputLayers.at(a).resType;
+        if (resType == "cover") {
+            game.coverFile = filenames.at(a);
+        } else if (resType == "screenshot") {
+            game.screenshotFile = filenames.at(a);
+        } else if (resType == "wheel") {
+            game.wheelFile = filenames.at(a);
+        } else if (resType == "marquee") {
+            game.marqueeFile = filenames.at(a);
+        } else if (resType == "texture") {
+            game.textureFile = filenames.at(a);
         }
     }
+    gameImages.fill(QImage());
 }
 
-void Compositor::processChildLayers(GameEntry &game, Layer &layer) {
-    for (int a = 0; a < layer.getLayers().length(); ++a) {
-        // Create new layer and set canvas to relevant resource (or empty if
-        // left out in xml)
-        Layer thisLayer = layer.getLayers().at(a);
-        if (thisLayer.type == T_LAYER) {
-            if (thisLayer.resource == "") {
-                QImage emptyCanvas(1, 1, QImage::Format_ARGB32_Premultiplied);
-                emptyCanvas.fill(Qt::transparent);
-                thisLayer.setCanvas(emptyCanvas);
-            } else if (thisLayer.resource == "cover") {
-                thisLayer.setCanvas(QImage::fromData(game.coverData));
-            } else if (thisLayer.resource == "screenshot") {
-                thisLayer.setCanvas(QImage::fromData(game.screenshotData));
-            } else if (thisLayer.resource == "wheel") {
-                thisLayer.setCanvas(QImage::fromData(game.wheelData));
-            } else if (thisLayer.resource == "marquee") {
-                thisLayer.setCanvas(QImage::fromData(game.marqueeData));
-            } else if (thisLayer.resource == "texture") {
-                thisLayer.setCanvas(QImage::fromData(game.textureData));
-            } else {
-                thisLayer.setCanvas(config->resources[thisLayer.resource]);
-            }
+QImage Compositor::getGameImage(const GameEntry &game, const int slot) {
+    if (slot < R_COVER || slot > R_TEXTURE) {
+        return QImage();
+    }
+    gameImagesMutex.lock();
+    bool cached = gameImagesDecoded.at(slot);
+    QImage image = gameImages.at(slot);
+    gameImagesMutex.unlock();
+    if (cached) {
+        return image;
+    }
 
-            // If no meaningful canvas could be created, stop processing this
-            // layer branch entirely
-            if (thisLayer.canvas.isNull()) {
-                continue;
-            }
+    // Decode outside the lock, other outputs may be decoding their resource
+    // meanwhile. Null images are kept as well, no need to fail decoding twice
+    image = decodeGameImage(gameData(game, slot))
+                .convertToFormat(QImage::Format_ARGB32_Premultiplied);
 
-            thisLayer.premultiply();
-            if (thisLayer.resource == "screenshot") {
-                // Crop away transparency and, if configured, black borders
-                // around screenshots
-                thisLayer.setCanvas(
-                    ImgTools::cropToFit(thisLayer.canvas, config->cropBlack));
-            } else {
-                // Crop away transparency around all other types. Never crop
-                // black on these as many have black outlines that are very much
-                // needed
-                thisLayer.setCanvas(ImgTools::cropToFit(thisLayer.canvas));
-            }
-            thisLayer.scale();
+    QMutexLocker locker(&gameImagesMutex);
+    if (!gameImagesDecoded.at(slot)) {
+        gameImages[slot] = image;
+        gameImagesDecoded[slot] = true;
+    }
+    return gameImages.at(slot);
+}
 
-            // Update width + height as we will need them for easier placement
-            // and alignment
-            thisLayer.updateSize();
+QString Compositor::passThroughFile(const GameEntry &game,
+                                    const Layer &output) {
+    // Anything but the bare game image in its own format needs rendering
+    if (config->artworkPassthrough == "off" || output.hasLayers() ||
+        output.slot < R_COVER || output.width != -1 || output.height != -1 ||
+        output.mPixels > 0.0 || output.compression != -1 ||
+        output.quality != -1) {
+        return QString();
+    }
+    const QString file =
+        game.cacheFiles.value(GAMEIMAGES.at(output.slot - R_COVER));
+    if (file.isEmpty()) {
+        return QString();
+    }
+    // Rendering doesn't save fully transparent images, and images unknown to
+    // the cache may be just that
+    const ImageInfo info = gameImageInfo(game, output.slot);
+    if (!info.content.isValid() || info.format != output.format) {
+        return QString();
+    }
+    return file;
+}
+
+QImage Compositor::decodeGameImage(const QByteArray &data) {
+    if (config->artworkPixelBudget <= 0) {
+        return QImage::fromData(data);
+    }
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    // Only the header is read for the size
+    const QSize size = reader.size();
+    const double pixels = (double)size.width() * size.height();
+    const double budget = config->artworkPixelBudget * 1000000.0;
+    if (size.isValid() && pixels > budget) {
+        // Never smaller than the largest output, as far as the xml tells
+        int width = 0;
+        int height = 0;
+        for (const auto &output : outputs->getLayers()) {
+            width = qMax(width, output.width);
+            height = qMax(height, output.height);
+        }
+        const double factor =
+            qMax(sqrt(budget / pixels), qMax((double)width / size.width(),
+                                             (double)height / size.height()));
+        if (factor < 1.0) {
+            // JPEG is decoded at that size right away, others are scaled
+            // once decoded
+            reader.setScaledSize(
+                QSize(qMax(1, qRound(size.width() * factor)),
+                      qMax(1, qRound(size.height() * factor))));
+        }
+    }
+    return reader.read();
+}
+
+ImageInfo Compositor::gameImageInfo(const GameEntry &game, const int slot) {
+    if (slot < R_COVER || slot > R_TEXTURE) {
+        return ImageInfo();
+    }
+    return game.imageInfos.value(GAMEIMAGES.at(slot - R_COVER));
+}
+
+QByteArray Compositor::gameData(const GameEntry &game, const int slot) {
+    switch (slot) {
+    case R_COVER:
+        return game.coverData;
+    case R_SCREENSHOT:
+        return game.screenshotData;
+    case R_WHEEL:
+        return game.wheelData;
+    case R_MARQUEE:
+        return game.marqueeData;
+    case R_TEXTURE:
+        return game.textureData;
+    default:
+        return QByteArray();
+    }
+}
+
+Canvas Compositor::renderLayer(GameEntry &game, const Layer &layer) {
+    // Set canvas to relevant resource (or empty if left out in xml)
+    Canvas canvas;
+    if (layer.slot == R_NONE) {
+        canvas.image = QImage(1, 1, QImage::Format_ARGB32_Premultiplied);
+        canvas.image.fill(Qt::transparent);
+    } else if (layer.slot == R_STATIC) {
+        canvas.image = config->resources.value(layer.resource);
+    } else {
+        canvas.image = getGameImage(game, layer.slot);
+    }
+
+    // If no meaningful canvas could be created, stop processing this layer
+    // branch entirely
+    if (canvas.image.isNull()) {
+        return canvas;
+    }
+
+    canvas.image =
+        canvas.image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    // Crop away transparency and, if configured, black borders around
+    // screenshots. Never crop black on other types as many have black
+    // outlines that are very much needed
+    const bool cropBlack = layer.slot == R_SCREENSHOT && config->cropBlack;
+    const ImageInfo info = gameImageInfo(game, layer.slot);
+    if (!cropBlack && info.width == canvas.image.width() &&
+        info.height == canvas.image.height()) {
+        // The cache knows the bounding box already, opaque images needn't
+        // even be copied
+        if (info.content.isValid() && info.content != canvas.image.rect()) {
+            canvas.image = canvas.image.copy(info.content);
+        }
+    } else {
+        canvas.image = ImgTools::cropToFit(canvas.image, cropBlack);
+    }
+    canvas.image = layer.scale(canvas.image);
+
+    // Update width + height as we will need them for easier placement and
+    // alignment
+    canvas.width = canvas.image.width();
+    canvas.height = canvas.image.height();
+
+    // Continue concurrency if this layer has children
+    if (layer.hasLayers()) {
+        processChildLayers(game, layer, canvas);
+    }
+    return canvas;
+}
 
-            // Continue concurrency if this layer has children
-            if (thisLayer.hasLayers()) {
-                processChildLayers(game, thisLayer);
+void Compositor::processChildLayers(GameEntry &game, const Layer &layer,
+                                    Canvas &canvas) {
+    const QList<Layer> &childLayers = layer.getLayers();
+
+    // Sibling layers only depend on each other once they are composited onto
+    // the parent canvas. Render their subtrees concurrently up front, unless
+    // memory is tight. Then only one of them exists at a time
+    const bool lowMemory = config->artworkPixelBudget > 0;
+    QVector<Canvas> childCanvases(childLayers.size());
+    QList<std::function<void()>> tasks;
+    for (int a = 0; a < childLayers.size() && !lowMemory; ++a) {
+        if (childLayers.at(a).type == T_LAYER) {
+            tasks.append([this, &game, &childLayers, &childCanvases, a]() {
+                childCanvases[a] = renderLayer(game, childLayers.at(a));
+            });
+        }
+    }
+    TaskPool::run(tasks);
+
+    for (int a = 0; a < childLayers.size(); ++a) {
+        const Layer &thisLayer = childLayers.at(a);
+        switch (thisLayer.type) {
+        case T_LAYER: {
+            // Released once composited
+            const Canvas child = lowMemory ? renderLayer(game, thisLayer)
+                                           : std::move(childCanvases[a]);
+            if (child.image.isNull()) {
+                continue;
             }
 
             // Composite image on canvas (which is the parent canvas at this
             // point)
             QPainter painter;
-            painter.begin(&layer.canvas);
+            painter.begin(&canvas.image);
             painter.setCompositionMode(thisLayer.mode);
             if (thisLayer.opacity != -1)
                 painter.setOpacity(thisLayer.opacity * 0.01);
 
             int x = 0;
-            if (thisLayer.align == "center") {
-                x = (layer.width / 2) - (thisLayer.width / 2);
-            } else if (thisLayer.align == "right") {
-                x = layer.width - thisLayer.width;
+            if (thisLayer.hAlign == A_CENTER) {
+                x = (canvas.width / 2) - (child.width / 2);
+            } else if (thisLayer.hAlign == A_END) {
+                x = canvas.width - child.width;
             }
             x += thisLayer.x;
 
             int y = 0;
-            if (thisLayer.valign == "middle") {
-                y = (layer.height / 2) - (thisLayer.height / 2);
-            } else if (thisLayer.valign == "bottom") {
-                y = layer.height - thisLayer.height;
+            if (thisLayer.vAlign == A_CENTER) {
+                y = (canvas.height / 2) - (child.height / 2);
+            } else if (thisLayer.vAlign == A_END) {
+                y = canvas.height - child.height;
             }
             y += thisLayer.y;
 
-            painter.drawImage(x, y, thisLayer.canvas);
+            painter.drawImage(x, y, child.image);
             painter.end();
-
-        } else if (thisLayer.type == T_SHADOW) {
-            FxShadow effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_BLUR) {
-            FxBlur effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_MASK) {
-            FxMask effect;
-            layer.setCanvas(
-                effect.applyEffect(layer.canvas, thisLayer, config));
-        } else if (thisLayer.type == T_FRAME) {
-            FxFrame effect;
-            layer.setCanvas(
-                effect.applyEffect(layer.canvas, thisLayer, config));
-        } else if (thisLayer.type == T_STROKE) {
-            FxStroke effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_ROUNDED) {
-            FxRounded effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_BRIGHTNESS) {
-            FxBrightness effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_CONTRAST) {
-            FxContrast effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_BALANCE) {
-            FxBalance effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_OPACITY) {
-            FxOpacity effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_GAMEBOX) {
-            FxGamebox effect;
-            layer.setCanvas(
-                effect.applyEffect(layer.canvas, thisLayer, game, config));
-        } else if (thisLayer.type == T_HUE) {
-            FxHue effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_SATURATION) {
-            FxSaturation effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_COLORIZE) {
-            FxColorize effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_ROTATE) {
-            FxRotate effect;
-            layer.setCanvas(effect.applyEffect(layer.canvas, thisLayer));
-        } else if (thisLayer.type == T_SCANLINES) {
-            FxScanlines effect;
-            layer.setCanvas(
-                effect.applyEffect(layer.canvas, thisLayer, config));
+            break;
+        }
+        case T_LUT:
+            FxKernels::applyLut(canvas.image, thisLayer.lut);
+            break;
+        // Effects that work in place get the canvas moved in, so they don't
+        // have to copy it
+        case T_BRIGHTNESS:
+        case T_CONTRAST:
+        case T_BALANCE:
+        case T_OPACITY:
+            canvas.image = applyPerChannel(std::move(canvas.image), thisLayer);
+            break;
+        case T_SHADOW:
+            canvas.image = FxShadow().applyEffect(canvas.image, thisLayer);
+            break;
+        case T_BLUR:
+            canvas.image =
+                FxBlur().applyEffect(std::move(canvas.image), thisLayer);
+            break;
+        case T_MASK:
+            canvas.image = FxMask().applyEffect(std::move(canvas.image),
+                                                thisLayer, config);
+            break;
+        case T_FRAME:
+            canvas.image = FxFrame().applyEffect(std::move(canvas.image),
+                                                 thisLayer, config);
+            break;
+        case T_STROKE:
+            canvas.image = FxStroke().applyEffect(canvas.image, thisLayer);
+            break;
+        case T_ROUNDED:
+            canvas.image =
+                FxRounded().applyEffect(std::move(canvas.image), thisLayer);
+            break;
+        case T_GAMEBOX: {
+            QImage sideImage =
+                thisLayer.slot >= R_COVER
+                    ? getGameImage(game, thisLayer.slot)
+                    : config->resources.value(thisLayer.resource);
+            canvas.image = FxGamebox().applyEffect(canvas.image, thisLayer,
+                                                   sideImage, config);
+            break;
+        }
+        case T_HUE:
+            canvas.image =
+                FxHue().applyEffect(std::move(canvas.image), thisLayer);
+            break;
+        case T_SATURATION:
+            canvas.image =
+                FxSaturation().applyEffect(std::move(canvas.image), thisLayer);
+            break;
+        case T_COLORIZE:
+            canvas.image =
+                FxColorize().applyEffect(std::move(canvas.image), thisLayer);
+            break;
+        case T_ROTATE:
+            canvas.image = FxRotate().applyEffect(canvas.image, thisLayer);
+            break;
+        case T_SCANLINES:
+            canvas.image = FxScanlines().applyEffect(std::move(canvas.image),
+                                                     thisLayer, config);
+            break;
         }
         // Update width and height only for effects that change the dimensions
         // in a way that necessitates an update. For instance T_SHADOW does NOT
@@ -509,7 +1021,8 @@ void Compositor::processChildLayers(GameEntry &game, Layer &layer) {
         // take the shadow into consideration.
         if (thisLayer.type == T_STROKE || thisLayer.type == T_ROTATE ||
             thisLayer.type == T_GAMEBOX) {
-            layer.updateSize();
+            canvas.width = canvas.image.width();
+            canvas.height = canvas.image.height();
         }
     }
 }
@@ -30,7 +30,12 @@
 #include "layer.h"
 #include "settings.h"
 
+#include <QDomDocument>
 #include <QImage>
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
 #include <QXmlStreamReader>
 
 class Compositor : public QObject {
@@ -41,12 +46,55 @@ public:
     bool processXml();
     void saveAll(GameEntry &game, QString completeBaseName);
     QString getSubpath(const QString &absPath);
+    // Saves which inputs the artwork files were made from, once all of them
+    // have been written
+    static void writeManifest();
 
 private:
     void addChildLayers(Layer &layer, QXmlStreamReader &xml);
-    void processChildLayers(GameEntry &game, Layer &layer);
+    void compileLayers(Layer &layer);
+    void resolveLayer(Layer &layer);
+    bool isDead(const Layer &layer);
+    static bool isPerChannel(const Layer &layer);
+    static QImage applyPerChannel(QImage canvas, const Layer &layer);
+    static QImage fuseEffects(const QList<Layer> &effects);
+    void digestOutputs(Layer &layer, const QDomDocument &doc);
+    static void collectResources(const Layer &layer, QStringList &names);
+    static int collectInputs(const Layer &layer);
+    static QByteArray gameDigest(const GameEntry &game, const Layer &output);
+    static QByteArray gameData(const GameEntry &game, const int slot);
+    static ImageInfo gameImageInfo(const GameEntry &game, const int slot);
+    // Cache file an output can be exported from as is, as it would come out
+    // of rendering unchanged and in the same format. Empty if there's none
+    QString passThroughFile(const GameEntry &game, const Layer &output);
+    bool isUpToDate(const QString &filename, const QByteArray &digest);
+    static void updateManifest(const QString &filename,
+                               const QByteArray &digest);
+    void processChildLayers(GameEntry &game, const Layer &layer,
+                            Canvas &canvas);
+    Canvas renderLayer(GameEntry &game, const Layer &layer);
+    QImage getGameImage(const GameEntry &game, const int slot);
+    // Decodes a game image, within config->artworkPixelBudget if set
+    QImage decodeGameImage(const QByteArray &data);
     Settings *config;
-    Layer outputs;
+    // Compiled artwork, read only and shared by all threads with the same
+    // artwork and resources
+    QSharedPointer<const Layer> outputs;
+    // Decoded and premultiplied resources of the game being composited,
+    // shared by all outputs and layers, indexed by slot. Never paint on
+    // these directly
+    QVector<QImage> gameImages;
+    QVector<bool> gameImagesDecoded;
+    QMutex gameImagesMutex;
+
+    static QMutex plansMutex;
+    static QMap<QString, QSharedPointer<const Layer>> plans;
+
+    // Digest of every artwork file written, by filename
+    static QMutex manifestMutex;
+    static QString manifestFile;
+    static QMap<QString, QByteArray> manifest;
+    static bool manifestChanged;
 };
 
 #endif // COMPOSITOR_H
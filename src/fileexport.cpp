@@ -0,0 +1,180 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include "fileexport.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <linux/fs.h>
+#include <sys/sendfile.h>
+// copy_file_range() came with glibc 2.27
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 27)
+#define EXPORT_COPY_FILE_RANGE
+#endif
+#elif defined(Q_OS_MACOS)
+#include <sys/clonefile.h>
+#endif
+#endif
+
+namespace {
+bool isUnchanged(const QFileInfo &source, const QString &target,
+                 const FileExport::Method preferred) {
+    QFileInfo info(target);
+    if (preferred == FileExport::SYMLINK) {
+        return info.isSymLink() &&
+               info.symLinkTarget() == source.absoluteFilePath();
+    }
+    // A symlink left by an earlier export is replaced as well
+    return info.exists() && !info.isSymLink() &&
+           info.size() == source.size() &&
+           info.lastModified() == source.lastModified();
+}
+
+bool hardlink(const QString &source, const QString &target) {
+#if defined(Q_OS_WIN)
+    return CreateHardLinkW((LPCWSTR)target.utf16(), (LPCWSTR)source.utf16(),
+                           nullptr);
+#else
+    return ::link(QFile::encodeName(source).constData(),
+                  QFile::encodeName(target).constData()) == 0;
+#endif
+}
+
+// Shares the extents of source until either file is written to. Only some
+// filesystems can do this, e.g. Btrfs, XFS and APFS
+bool reflink(const QString &source, const QString &target) {
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+    int in = ::open(QFile::encodeName(source).constData(), O_RDONLY);
+    if (in < 0) {
+        return false;
+    }
+    int out = ::open(QFile::encodeName(target).constData(),
+                     O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        ::close(in);
+        return false;
+    }
+    bool ok = ::ioctl(out, FICLONE, in) == 0;
+    ::close(out);
+    ::close(in);
+    if (!ok) {
+        QFile::remove(target);
+    }
+    return ok;
+#elif defined(Q_OS_MACOS)
+    return ::clonefile(QFile::encodeName(source).constData(),
+                       QFile::encodeName(target).constData(), 0) == 0;
+#else
+    Q_UNUSED(source);
+    Q_UNUSED(target);
+    return false;
+#endif
+}
+
+// Copies without passing the data through user space
+bool kernelCopy(const QString &source, const QString &target) {
+#if defined(Q_OS_LINUX)
+    int in = ::open(QFile::encodeName(source).constData(), O_RDONLY);
+    if (in < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(in, &st) != 0) {
+        ::close(in);
+        return false;
+    }
+    int out = ::open(QFile::encodeName(target).constData(),
+                     O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        ::close(in);
+        return false;
+    }
+    off_t left = st.st_size;
+    while (left > 0) {
+        ssize_t done = -1;
+#ifdef EXPORT_COPY_FILE_RANGE
+        done = ::copy_file_range(in, nullptr, out, nullptr, left, 0);
+#endif
+        if (done <= 0) {
+            // Older kernels don't copy across filesystems. Both advance the
+            // file offsets, so they can take turns
+            done = ::sendfile(out, in, nullptr, left);
+        }
+        if (done <= 0) {
+            break;
+        }
+        left -= done;
+    }
+    ::close(out);
+    ::close(in);
+    if (left > 0) {
+        QFile::remove(target);
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(source);
+    Q_UNUSED(target);
+    return false;
+#endif
+}
+
+void keepModified(const QString &target, const QDateTime &modified) {
+    QFile file(target);
+    if (file.open(QIODevice::Append)) {
+        file.setFileTime(modified, QFileDevice::FileModificationTime);
+    }
+}
+} // namespace
+
+FileExport::Method FileExport::place(const QString &source,
+                                     const QString &target,
+                                     const Method preferred) {
+    const QFileInfo info(source);
+    if (isUnchanged(info, target, preferred)) {
+        return UNCHANGED;
+    }
+    QFile::remove(target);
+    if (preferred == SYMLINK) {
+        return QFile::link(source, target) ? SYMLINK : FAILED;
+    }
+    if (preferred == HARDLINK && hardlink(source, target)) {
+        return HARDLINK;
+    }
+    Method method = FAILED;
+    if (reflink(source, target)) {
+        method = REFLINK;
+    } else if (kernelCopy(source, target) || QFile::copy(source, target)) {
+        method = COPY;
+    }
+    if (method != FAILED) {
+        keepModified(target, info.lastModified());
+    }
+    return method;
+}
@@ -0,0 +1,41 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef FILEEXPORT_H
+#define FILEEXPORT_H
+
+#include <QString>
+
+namespace FileExport {
+    // How a file ended up at its target. SYMLINK, HARDLINK and COPY are
+    // also what place() is asked for
+    enum Method { FAILED, UNCHANGED, SYMLINK, HARDLINK, REFLINK, COPY };
+
+    // Places source at target without reading it into memory. A target of
+    // the same size and modification time as source is kept, copies are
+    // given the time of source for this. SYMLINK links to source or fails.
+    // HARDLINK shares the data of source, which suits files that are never
+    // edited in place. Both it and COPY fall back to a copy on write clone,
+    // then to a copy within the kernel and last to a regular copy. An
+    // outdated target is replaced
+    Method place(const QString &source, const QString &target,
+                 const Method preferred);
+} // namespace FileExport
+
+#endif // FILEEXPORT_H
@@ -25,46 +25,16 @@
 
 #include "fxbalance.h"
 
-#include <QPainter>
-#include <cmath>
+#include "fxkernels.h"
 
 FxBalance::FxBalance() {}
 
-QImage FxBalance::applyEffect(const QImage &src, const Layer &layer) {
-    QImage canvas = src;
-
-    int redValue = layer.red;
-    int greenValue = layer.green;
-    int blueValue = layer.blue;
-
-    int indexRed[256];
-    int indexGreen[256];
-    int indexBlue[256];
-    for (int a = 0; a < 256; ++a) {
-        indexRed[a] = truncate(a + redValue);
-        indexGreen[a] = truncate(a + greenValue);
-        indexBlue[a] = truncate(a + blueValue);
-    }
-
-    for (int y = 0; y < canvas.height(); ++y) {
-        QRgb *line = (QRgb *)canvas.scanLine(y);
-        for (int x = 0; x < canvas.width(); ++x) {
-
-            line[x] = qPremultiply(
-                qRgba(indexRed[qRed(line[x])], indexGreen[qGreen(line[x])],
-                      indexBlue[qBlue(line[x])], qAlpha(line[x])));
-        }
-    }
+QImage FxBalance::applyEffect(QImage canvas, const Layer &layer) {
+    // Channels left out in the xml are -1 and darken by one, as they always
+    // have
+    const int mul[4] = {256, 256, 256, 256};
+    const int offset[3] = {layer.red, layer.green, layer.blue};
+    FxKernels::scaleOffset(canvas, mul, offset);
 
     return canvas;
 }
-
-int FxBalance::truncate(int value) {
-    if (value > 255) {
-        value = 255;
-    }
-    if (value < 0) {
-        value = 0;
-    }
-    return value;
-}
@@ -36,10 +36,7 @@ class FxBalance : public QObject {
 
 public:
     FxBalance();
-    QImage applyEffect(const QImage &src, const Layer &layer);
-
-private:
-    int truncate(int value);
+    QImage applyEffect(QImage canvas, const Layer &layer);
 };
 
 #endif // FXBALANCE_H
@@ -38,15 +38,7 @@ class FxBlur : public QObject {
 
 public:
     FxBlur();
-    QImage applyEffect(const QImage &src, const Layer &layer);
-
-private:
-    void boxBlur(QRgb *buffer1, QRgb *buffer2, int width, int height,
-                 int radius);
-    void boxBlurHorizontal(QRgb *buffer1, QRgb *buffer2, int width, int height,
-                           int radius);
-    void boxBlurTotal(QRgb *buffer1, QRgb *buffer2, int width, int height,
-                      int radius);
+    QImage applyEffect(QImage canvas, const Layer &layer);
 };
 
 #endif // FXBLUR_H
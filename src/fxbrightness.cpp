@@ -25,39 +25,14 @@
 
 #include "fxbrightness.h"
 
-#include <QPainter>
-#include <cmath>
+#include "fxkernels.h"
 
 FxBrightness::FxBrightness() {}
 
-QImage FxBrightness::applyEffect(const QImage &src, const Layer &layer) {
-    QImage canvas = src;
-
-    int brightness = layer.delta;
-    int index[256];
-    for (int a = 0; a < 256; ++a) {
-        index[a] = truncate(a + brightness);
-    }
-
-    for (int y = 0; y < canvas.height(); ++y) {
-        QRgb *line = (QRgb *)canvas.scanLine(y);
-        for (int x = 0; x < canvas.width(); ++x) {
-
-            line[x] =
-                qPremultiply(qRgba(index[qRed(line[x])], index[qGreen(line[x])],
-                                   index[qBlue(line[x])], qAlpha(line[x])));
-        }
-    }
+QImage FxBrightness::applyEffect(QImage canvas, const Layer &layer) {
+    const int mul[4] = {256, 256, 256, 256};
+    const int offset[3] = {layer.delta, layer.delta, layer.delta};
+    FxKernels::scaleOffset(canvas, mul, offset);
 
     return canvas;
 }
-
-int FxBrightness::truncate(int value) {
-    if (value > 255) {
-        value = 255;
-    }
-    if (value < 0) {
-        value = 0;
-    }
-    return value;
-}
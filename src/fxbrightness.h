@@ -36,10 +36,7 @@ class FxBrightness : public QObject {
 
 public:
     FxBrightness();
-    QImage applyEffect(const QImage &src, const Layer &layer);
-
-private:
-    int truncate(int value);
+    QImage applyEffect(QImage canvas, const Layer &layer);
 };
 
 #endif // FXBRIGHTNESS_H
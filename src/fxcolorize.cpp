@@ -25,14 +25,11 @@
 
 #include "fxcolorize.h"
 
-#include <QPainter>
-#include <cmath>
+#include "fxkernels.h"
 
 FxColorize::FxColorize() {}
 
-QImage FxColorize::applyEffect(const QImage &src, const Layer &layer) {
-    QImage canvas = src;
-
+QImage FxColorize::applyEffect(QImage canvas, const Layer &layer) {
     int hue = layer.value;
     int satDelta = layer.delta;
 
@@ -45,17 +42,7 @@ QImage FxColorize::applyEffect(const QImage &src, const Layer &layer) {
     }
     int saturation = 127 + satDelta;
 
-    for (int y = 0; y < canvas.height(); ++y) {
-        QRgb *line = (QRgb *)canvas.scanLine(y);
-        for (int x = 0; x < canvas.width(); ++x) {
-            QColor color(line[x]);
-            // https://en.wikipedia.org/wiki/Grayscale#Colorimetric_(perceptual_luminance-preserving)_conversion_to_grayscale
-            const int v = qRed(line[x]) * 0.2126 + qGreen(line[x]) * 0.7152 +
-                          qBlue(line[x]) * 0.0722;
-            color.setHsl(hue, saturation, v, qAlpha(line[x]));
-            line[x] = qPremultiply(color.rgba());
-        }
-    }
+    FxKernels::colorize(canvas, hue, saturation);
 
     return canvas;
 }
@@ -36,10 +36,7 @@ class FxColorize : public QObject {
 
 public:
     FxColorize();
-    QImage applyEffect(const QImage &src, const Layer &layer);
-
-private:
-    int truncate(int value);
+    QImage applyEffect(QImage canvas, const Layer &layer);
 };
 
 #endif // FXCOLORIZE_H
@@ -25,43 +25,21 @@
 
 #include "fxcontrast.h"
 
-#include <QPainter>
-#include <cmath>
+#include "fxkernels.h"
 
 FxContrast::FxContrast() {}
 
-QImage FxContrast::applyEffect(const QImage &src, const Layer &layer) {
-    QImage canvas = src;
-
+QImage FxContrast::applyEffect(QImage canvas, const Layer &layer) {
     int contrast = layer.delta;
 
     double factor = (259.0 * ((double)contrast + 255.0)) /
                     (255.0 * (259.0 - (double)contrast));
 
-    double index[256];
-    for (int a = 0; a < 256; ++a) {
-        index[a] = truncate(round(factor * a));
-    }
-
-    for (int y = 0; y < canvas.height(); ++y) {
-        QRgb *line = (QRgb *)canvas.scanLine(y);
-        for (int x = 0; x < canvas.width(); ++x) {
-
-            line[x] =
-                qPremultiply(qRgba(index[qRed(line[x])], index[qGreen(line[x])],
-                                   index[qBlue(line[x])], qAlpha(line[x])));
-        }
-    }
+    // Factor in 1/256 steps, anything above 255 saturates every colour > 0
+    const int scale = factor > 255.0 ? 65535 : qRound(factor * 256.0);
+    const int mul[4] = {scale, scale, scale, 256};
+    const int offset[3] = {0, 0, 0};
+    FxKernels::scaleOffset(canvas, mul, offset);
 
     return canvas;
 }
-
-int FxContrast::truncate(int value) {
-    if (value > 255) {
-        value = 255;
-    }
-    if (value < 0) {
-        value = 0;
-    }
-    return value;
-}
@@ -36,10 +36,7 @@ class FxContrast : public QObject {
 
 public:
     FxContrast();
-    QImage applyEffect(const QImage &src, const Layer &layer);
-
-private:
-    int truncate(int value);
+    QImage applyEffect(QImage canvas, const Layer &layer);
 };
 
 #endif // FXCONTRAST_H
@@ -25,29 +25,41 @@
 
 #include "fxframe.h"
 
+#include "imgtools.h"
+
 #include <QPainter>
 #include <cmath>
 
 FxFrame::FxFrame() {}
 
-QImage FxFrame::applyEffect(const QImage &src, const Layer &layer,
+QImage FxFrame::applyEffect(QImage canvas, const Layer &layer,
                             Settings *config) {
-    QImage canvas = src;
-
-    QImage frame(config->resources[layer.resource]);
-    frame = frame.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-
-    if (layer.width == -1 && layer.height == -1) {
-        frame = frame.scaled(src.width(), src.height(), Qt::IgnoreAspectRatio,
-                             Qt::SmoothTransformation);
-    } else if (layer.width == -1 && layer.height != -1) {
-        frame = frame.scaledToHeight(layer.height, Qt::SmoothTransformation);
-    } else if (layer.width != -1 && layer.height == -1) {
-        frame = frame.scaledToWidth(layer.width, Qt::SmoothTransformation);
-    } else if (layer.width != -1 && layer.height != -1) {
-        frame = frame.scaled(layer.width, layer.height, layer.aspect,
-                             Qt::SmoothTransformation);
-    }
+    // Only depends on the resource and the target size, not on the game
+    const QString key = QString("frame:%1:%2x%3:%4x%5:%6")
+                            .arg(layer.resource)
+                            .arg(canvas.width())
+                            .arg(canvas.height())
+                            .arg(layer.width)
+                            .arg(layer.height)
+                            .arg((int)layer.aspect);
+    const QImage frame = ImgTools::derived(key, [&]() {
+        QImage scaled = config->resources.value(layer.resource);
+        if (layer.width == -1 && layer.height == -1) {
+            scaled = scaled.scaled(canvas.width(), canvas.height(),
+                                   Qt::IgnoreAspectRatio,
+                                   Qt::SmoothTransformation);
+        } else if (layer.width == -1 && layer.height != -1) {
+            scaled =
+                scaled.scaledToHeight(layer.height, Qt::SmoothTransformation);
+        } else if (layer.width != -1 && layer.height == -1) {
+            scaled =
+                scaled.scaledToWidth(layer.width, Qt::SmoothTransformation);
+        } else if (layer.width != -1 && layer.height != -1) {
+            scaled = scaled.scaled(layer.width, layer.height, layer.aspect,
+                                   Qt::SmoothTransformation);
+        }
+        return scaled;
+    });
 
     QPainter painter;
     painter.begin(&canvas);
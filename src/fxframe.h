@@ -36,7 +36,7 @@ class FxFrame : public QObject {
 
 public:
     FxFrame();
-    QImage applyEffect(const QImage &src, const Layer &layer, Settings *config);
+    QImage applyEffect(QImage canvas, const Layer &layer, Settings *config);
 };
 
 #endif // FXFRAME_H
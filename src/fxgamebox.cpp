@@ -25,6 +25,8 @@
 
 #include "fxgamebox.h"
 
+#include "imgtools.h"
+
 #include <QPainter>
 #include <QTransform>
 #include <cmath>
@@ -32,7 +34,7 @@
 FxGamebox::FxGamebox() {}
 
 QImage FxGamebox::applyEffect(const QImage &src, const Layer &layer,
-                              const GameEntry &game, Settings *config) {
+                              const QImage &spine, Settings *config) {
     QPainter painter;
     QTransform trans;
     double borderFactor = 0.029;
@@ -40,10 +42,13 @@ QImage FxGamebox::applyEffect(const QImage &src, const Layer &layer,
     QImage front(src.width() - src.width() * borderFactor, src.height(),
                  QImage::Format_ARGB32_Premultiplied);
     front.fill(Qt::black);
-    QImage overlayFront(config->resources["boxfront.png"]);
-    overlayFront =
-        overlayFront.scaled(front.width(), front.height(),
-                            Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    const QImage overlayFront = ImgTools::derived(
+        QString("boxfront:%1x%2").arg(front.width()).arg(front.height()),
+        [&]() {
+            return config->resources.value("boxfront.png")
+                .scaled(front.width(), front.height(), Qt::IgnoreAspectRatio,
+                        Qt::SmoothTransformation);
+        });
 
     painter.begin(&front);
     painter.drawImage(
@@ -52,32 +57,20 @@ QImage FxGamebox::applyEffect(const QImage &src, const Layer &layer,
     painter.drawImage(0, 0, overlayFront);
     painter.end();
 
-    QImage overlaySide(config->resources["boxside.png"]);
-    overlaySide =
-        overlaySide.scaledToHeight(front.height(), Qt::SmoothTransformation);
+    const QImage overlaySide = ImgTools::derived(
+        QString("boxside:%1").arg(front.height()), [&]() {
+            return config->resources.value("boxside.png")
+                .scaledToHeight(front.height(), Qt::SmoothTransformation);
+        });
 
     QImage side(overlaySide.width(), overlaySide.height(),
                 QImage::Format_ARGB32_Premultiplied);
 
     fillWithAvg(src, side);
 
-    QImage sideImage;
-    if (layer.resource == "cover") {
-        sideImage = QImage::fromData(game.coverData);
-    } else if (layer.resource == "screenshot") {
-        sideImage = QImage::fromData(game.screenshotData);
-    } else if (layer.resource == "wheel") {
-        sideImage = QImage::fromData(game.wheelData);
-    } else if (layer.resource == "marquee") {
-        sideImage = QImage::fromData(game.marqueeData);
-    } else {
-        sideImage = QImage(config->resources[layer.resource]);
-    }
-    sideImage = sideImage.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-
     trans.reset();
     trans.rotate(layer.delta, Qt::ZAxis);
-    sideImage = sideImage.transformed(trans, Qt::SmoothTransformation);
+    QImage sideImage = spine.transformed(trans, Qt::SmoothTransformation);
     if (!sideImage.isNull()) {
         // Scale spine / side artwork
         if (layer.scaling == "") {
@@ -26,7 +26,6 @@
 #ifndef FXGAMEBOX_H
 #define FXGAMEBOX_H
 
-#include "gameentry.h"
 #include "layer.h"
 #include "settings.h"
 
@@ -38,7 +37,7 @@ class FxGamebox : public QObject {
 public:
     FxGamebox();
     QImage applyEffect(const QImage &src, const Layer &layer,
-                       const GameEntry &game, Settings *config);
+                       const QImage &spine, Settings *config);
 
 private:
     void fillWithAvg(const QImage &src, QImage &dst);
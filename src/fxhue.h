@@ -36,7 +36,7 @@ class FxHue : public QObject {
 
 public:
     FxHue();
-    QImage applyEffect(const QImage &src, const Layer &layer);
+    QImage applyEffect(QImage canvas, const Layer &layer);
 };
 
 #endif // FXHUE_H
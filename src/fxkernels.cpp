@@ -0,0 +1,732 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include "fxkernels.h"
+
+#include "taskpool.h"
+
+#include <QColor>
+#include <QVector>
+#include <QtGlobal>
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+#if defined(__SSE2__) || defined(_M_X64)
+#define FX_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define FX_AVX2
+#include <immintrin.h>
+#endif
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define FX_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace {
+// Factors per byte of a pixel in memory order: blue, green, red, alpha
+struct Params {
+    quint16 mul[4];
+    quint16 pos[4];
+    quint16 neg[4];
+};
+
+typedef void (*LineKernel)(quint32 *, int, const Params &);
+
+// x / 255 rounded, exact for x in [0, 65535 - 383]
+inline quint32 div255(quint32 x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+void scaleOffsetScalar(quint32 *pixels, int count, const Params &p) {
+    for (int i = 0; i < count; ++i) {
+        const quint32 v = pixels[i];
+        const quint32 a = v >> 24;
+        quint32 out = 0;
+        for (int c = 0; c < 4; ++c) {
+            quint32 t = (((v >> (c * 8)) & 0xff) * p.mul[c]) >> 8;
+            t += div255(a * p.pos[c]);
+            const quint32 neg = div255(a * p.neg[c]);
+            t = t > neg ? t - neg : 0;
+            out |= qMin(t, a) << (c * 8);
+        }
+        pixels[i] = out;
+    }
+}
+
+#ifdef FX_SSE2
+// Two pixels as 16 bit lanes
+inline __m128i sse2Pixels(__m128i x, const __m128i &mul, const __m128i &pos,
+                          const __m128i &neg) {
+    const __m128i c128 = _mm_set1_epi16(128);
+    // Alpha of each pixel in all of its four lanes
+    __m128i a = _mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+    a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i t = _mm_mulhi_epu16(_mm_slli_epi16(x, 8), mul);
+    __m128i o = _mm_add_epi16(_mm_mullo_epi16(a, pos), c128);
+    t = _mm_adds_epu16(t, _mm_srli_epi16(_mm_add_epi16(o, _mm_srli_epi16(o, 8)),
+                                         8));
+    o = _mm_add_epi16(_mm_mullo_epi16(a, neg), c128);
+    t = _mm_subs_epu16(t, _mm_srli_epi16(_mm_add_epi16(o, _mm_srli_epi16(o, 8)),
+                                         8));
+    // min(t, a), SSE2 has no unsigned 16 bit min
+    return _mm_sub_epi16(t, _mm_subs_epu16(t, a));
+}
+
+void scaleOffsetSse2(quint32 *pixels, int count, const Params &p) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mul =
+        _mm_setr_epi16(p.mul[0], p.mul[1], p.mul[2], p.mul[3], p.mul[0],
+                       p.mul[1], p.mul[2], p.mul[3]);
+    const __m128i pos =
+        _mm_setr_epi16(p.pos[0], p.pos[1], p.pos[2], p.pos[3], p.pos[0],
+                       p.pos[1], p.pos[2], p.pos[3]);
+    const __m128i neg =
+        _mm_setr_epi16(p.neg[0], p.neg[1], p.neg[2], p.neg[3], p.neg[0],
+                       p.neg[1], p.neg[2], p.neg[3]);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(pixels + i));
+        __m128i lo = sse2Pixels(_mm_unpacklo_epi8(v, zero), mul, pos, neg);
+        __m128i hi = sse2Pixels(_mm_unpackhi_epi8(v, zero), mul, pos, neg);
+        _mm_storeu_si128((__m128i *)(pixels + i), _mm_packus_epi16(lo, hi));
+    }
+    scaleOffsetScalar(pixels + i, count - i, p);
+}
+#endif
+
+#ifdef FX_AVX2
+// Same as sse2Pixels() on four pixels
+__attribute__((target("avx2"))) inline __m256i
+avx2Pixels(__m256i x, const __m256i &mul, const __m256i &pos,
+           const __m256i &neg) {
+    const __m256i c128 = _mm256_set1_epi16(128);
+    __m256i a = _mm256_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+    a = _mm256_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i t = _mm256_mulhi_epu16(_mm256_slli_epi16(x, 8), mul);
+    __m256i o = _mm256_add_epi16(_mm256_mullo_epi16(a, pos), c128);
+    t = _mm256_adds_epu16(
+        t, _mm256_srli_epi16(_mm256_add_epi16(o, _mm256_srli_epi16(o, 8)), 8));
+    o = _mm256_add_epi16(_mm256_mullo_epi16(a, neg), c128);
+    t = _mm256_subs_epu16(
+        t, _mm256_srli_epi16(_mm256_add_epi16(o, _mm256_srli_epi16(o, 8)), 8));
+    return _mm256_min_epu16(t, a);
+}
+
+__attribute__((target("avx2"))) void
+scaleOffsetAvx2(quint32 *pixels, int count, const Params &p) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mul = _mm256_setr_epi16(
+        p.mul[0], p.mul[1], p.mul[2], p.mul[3], p.mul[0], p.mul[1], p.mul[2],
+        p.mul[3], p.mul[0], p.mul[1], p.mul[2], p.mul[3], p.mul[0], p.mul[1],
+        p.mul[2], p.mul[3]);
+    const __m256i pos = _mm256_setr_epi16(
+        p.pos[0], p.pos[1], p.pos[2], p.pos[3], p.pos[0], p.pos[1], p.pos[2],
+        p.pos[3], p.pos[0], p.pos[1], p.pos[2], p.pos[3], p.pos[0], p.pos[1],
+        p.pos[2], p.pos[3]);
+    const __m256i neg = _mm256_setr_epi16(
+        p.neg[0], p.neg[1], p.neg[2], p.neg[3], p.neg[0], p.neg[1], p.neg[2],
+        p.neg[3], p.neg[0], p.neg[1], p.neg[2], p.neg[3], p.neg[0], p.neg[1],
+        p.neg[2], p.neg[3]);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // Unpack and pack work per 128 bit lane, so the order is kept
+        __m256i v = _mm256_loadu_si256((const __m256i *)(pixels + i));
+        __m256i lo =
+            avx2Pixels(_mm256_unpacklo_epi8(v, zero), mul, pos, neg);
+        __m256i hi =
+            avx2Pixels(_mm256_unpackhi_epi8(v, zero), mul, pos, neg);
+        _mm256_storeu_si256((__m256i *)(pixels + i),
+                            _mm256_packus_epi16(lo, hi));
+    }
+    scaleOffsetSse2(pixels + i, count - i, p);
+}
+#endif
+
+#ifdef FX_NEON
+inline uint16x8_t neonDiv255(uint16x8_t x) {
+    x = vaddq_u16(x, vdupq_n_u16(128));
+    return vshrq_n_u16(vaddq_u16(x, vshrq_n_u16(x, 8)), 8);
+}
+
+// Two pixels as 16 bit lanes, alpha already spread over all four lanes
+inline uint16x8_t neonPixels(uint16x8_t x, uint16x8_t a, const uint16x8_t &mul,
+                             const uint16x8_t &pos, const uint16x8_t &neg) {
+    uint16x8_t t =
+        vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(x),
+                                           vget_low_u16(mul)),
+                                 8),
+                     vshrn_n_u32(vmull_high_u16(x, mul), 8));
+    t = vqaddq_u16(t, neonDiv255(vmulq_u16(a, pos)));
+    t = vqsubq_u16(t, neonDiv255(vmulq_u16(a, neg)));
+    return vminq_u16(t, a);
+}
+
+void scaleOffsetNeon(quint32 *pixels, int count, const Params &p) {
+    const uint16_t mulLanes[8] = {p.mul[0], p.mul[1], p.mul[2], p.mul[3],
+                                  p.mul[0], p.mul[1], p.mul[2], p.mul[3]};
+    const uint16_t posLanes[8] = {p.pos[0], p.pos[1], p.pos[2], p.pos[3],
+                                  p.pos[0], p.pos[1], p.pos[2], p.pos[3]};
+    const uint16_t negLanes[8] = {p.neg[0], p.neg[1], p.neg[2], p.neg[3],
+                                  p.neg[0], p.neg[1], p.neg[2], p.neg[3]};
+    const uint8_t alphaIdx[16] = {3,  3,  3,  3,  7,  7,  7,  7,
+                                  11, 11, 11, 11, 15, 15, 15, 15};
+    const uint16x8_t mul = vld1q_u16(mulLanes);
+    const uint16x8_t pos = vld1q_u16(posLanes);
+    const uint16x8_t neg = vld1q_u16(negLanes);
+    const uint8x16_t idx = vld1q_u8(alphaIdx);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint8x16_t v = vld1q_u8((const uint8_t *)(pixels + i));
+        uint8x16_t a = vqtbl1q_u8(v, idx);
+        uint16x8_t lo = neonPixels(vmovl_u8(vget_low_u8(v)),
+                                   vmovl_u8(vget_low_u8(a)), mul, pos, neg);
+        uint16x8_t hi = neonPixels(vmovl_high_u8(v), vmovl_high_u8(a), mul,
+                                   pos, neg);
+        vst1q_u8((uint8_t *)(pixels + i),
+                 vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)));
+    }
+    scaleOffsetScalar(pixels + i, count - i, p);
+}
+#endif
+
+// Pixels per row range when an image is split up for the thread pool
+constexpr int MINCHUNK = 64 * 1024;
+
+// Hue in 1/100 degrees as QColor::toHsv() rounds it, delta > 0
+inline int hue100(int r, int g, int b, int max, int delta) {
+    int num;
+    if (r == max) {
+        num = 6000 * (g - b);
+        if (num < 0) {
+            num += 36000 * delta;
+        }
+    } else if (g == max) {
+        num = 12000 * delta + 6000 * (b - r);
+    } else {
+        num = 24000 * delta + 6000 * (r - g);
+    }
+    return (2 * num + delta) / (2 * delta);
+}
+
+// Colour of QColor::setHsv() with 8 bit saturation s and value v. k / 15300
+// is the part of v, the channel is qRound(v / 255 * k / 15300 * 65535) >> 8
+inline int hsvChannel(int v, int k) {
+    return ((2 * v * k * 257 + 15300) / 30600) >> 8;
+}
+
+QRgb fromHsv(int h, int s, int v, int a) {
+    if (s == 0 || h < 0) {
+        return qRgba(v, v, v, a);
+    }
+    const int f = h % 60;
+    const int p = hsvChannel(v, (255 - s) * 60);
+    const int q = hsvChannel(v, 15300 - s * f);
+    const int t = hsvChannel(v, 15300 - s * (60 - f));
+    switch (h / 60) {
+    case 0:
+        return qRgba(v, t, p, a);
+    case 1:
+        return qRgba(q, v, p, a);
+    case 2:
+        return qRgba(p, v, t, a);
+    case 3:
+        return qRgba(p, q, v, a);
+    case 4:
+        return qRgba(t, p, v, a);
+    default:
+        return qRgba(v, p, q, a);
+    }
+}
+
+// Port of the HSL branch of QColor::toRgb() for 8 bit h, s, l. Only called
+// for chromatic colours
+QRgb fromHsl(int h, int s, int l, int a) {
+    if (l == 0) {
+        return qRgba(0, 0, 0, a);
+    }
+    const double hh = h / 360.0;
+    const double ss = s / 255.0;
+    const double ll = l / 255.0;
+    const double temp2 = ll < 0.5 ? ll * (1.0 + ss) : ll + ss - ll * ss;
+    const double temp1 = 2.0 * ll - temp2;
+    double temp3[3] = {hh + 1.0 / 3.0, hh, hh - 1.0 / 3.0};
+    int out[3];
+    for (int i = 0; i < 3; ++i) {
+        if (temp3[i] < 0.0) {
+            temp3[i] += 1.0;
+        } else if (temp3[i] > 1.0) {
+            temp3[i] -= 1.0;
+        }
+        double c;
+        if (temp3[i] * 6.0 < 1.0) {
+            c = temp1 + (temp2 - temp1) * temp3[i] * 6.0;
+        } else if (temp3[i] * 2.0 < 1.0) {
+            c = temp2;
+        } else if (temp3[i] * 3.0 < 2.0) {
+            c = temp1 + (temp2 - temp1) * (2.0 / 3.0 - temp3[i]) * 6.0;
+        } else {
+            c = temp1;
+        }
+        out[i] = qRound(c * 65535) >> 8;
+    }
+    return qRgba(out[0], out[1], out[2], a);
+}
+
+LineKernel scaleOffsetKernel(const FxKernels::Isa isa) {
+    switch (isa) {
+#ifdef FX_AVX2
+    case FxKernels::ISA_AVX2:
+        return scaleOffsetAvx2;
+#endif
+#ifdef FX_SSE2
+    case FxKernels::ISA_SSE2:
+        return scaleOffsetSse2;
+#endif
+#ifdef FX_NEON
+    case FxKernels::ISA_NEON:
+        return scaleOffsetNeon;
+#endif
+    default:
+        return scaleOffsetScalar;
+    }
+}
+
+// Runs range() on [0, count) or on parts of it in parallel. Every part has
+// at least MINCHUNK pixels, pixels is the number per unit of count
+void forRanges(const bool parallel, const int count, const int pixels,
+               const std::function<void(int, int)> &range) {
+    if (!parallel || (qint64)count * pixels < 2 * MINCHUNK) {
+        range(0, count);
+        return;
+    }
+    TaskPool::runRanges(count, qMax(1, MINCHUNK / qMax(1, pixels)), range);
+}
+
+// Rows of a premultiplied ARGB32 image. The tasks must not call scanLine(),
+// it detaches and that isn't thread safe
+void forRows(QImage &image, const bool parallel,
+             const std::function<void(QRgb *, int)> &row) {
+    if (image.format() != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+    uchar *bits = image.bits();
+    const qint64 bpl = image.bytesPerLine();
+    const int width = image.width();
+    forRanges(parallel, image.height(), width,
+              [bits, bpl, width, &row](int begin, int end) {
+                  for (int y = begin; y < end; ++y) {
+                      row((QRgb *)(bits + y * bpl), width);
+                  }
+              });
+}
+
+// Calls pixel() with the straight colour of every not fully transparent
+// pixel and stores its premultiplied result
+template <typename F>
+void mapStraight(QImage &image, const bool parallel, const F &pixel) {
+    forRows(image, parallel, [&pixel](QRgb *line, int width) {
+        for (int x = 0; x < width; ++x) {
+            const QRgb v = line[x];
+            const int a = qAlpha(v);
+            if (a == 0) {
+                continue;
+            }
+            const QRgb out = pixel(a == 255 ? v : qUnpremultiply(v));
+            line[x] = a == 255 ? out : qPremultiply(out);
+        }
+    });
+}
+
+// Box blur. A window covers span = 2 * radius + 1 values, edge values are
+// repeated. The mean is (sum + 0.5) / span in float, truncated. That is
+// exact for span up to 2 * MAXBLURRADIUS + 1: the quotient is at least
+// 0.5 / span away from the next integer, more than the float error
+constexpr int MAXBLURRADIUS = 2000;
+
+inline quint8 boxMean(quint32 sum, float inv) {
+    return (quint8)(((float)sum + 0.5f) * inv);
+}
+
+// Horizontal pass over one row of C byte pixels
+template <int C>
+void blurRowScalar(const quint8 *src, quint8 *dst, int width, int radius) {
+    const float inv = 1.0f / (2 * radius + 1);
+    const int last = width - 1;
+    for (int c = 0; c < C; ++c) {
+        quint32 sum = (radius + 1) * src[c];
+        for (int x = 1; x <= radius; ++x) {
+            sum += src[qMin(x, last) * C + c];
+        }
+        for (int x = 0; x < width; ++x) {
+            dst[x * C + c] = boxMean(sum, inv);
+            sum += src[qMin(x + radius + 1, last) * C + c];
+            sum -= src[qMax(x - radius, 0) * C + c];
+        }
+    }
+}
+
+// Vertical pass over the bytes [begin, end) of all rows. The window sums
+// of a whole strip of columns are updated row by row, so memory is read in
+// order instead of column wise
+void blurColumnsScalar(const quint8 *src, quint8 *dst, qint64 bpl,
+                       int height, int radius, int begin, int end) {
+    const float inv = 1.0f / (2 * radius + 1);
+    const int last = height - 1;
+    const int count = end - begin;
+    std::vector<quint32> sum(count);
+    src += begin;
+    dst += begin;
+    for (int i = 0; i < count; ++i) {
+        sum[i] = (radius + 1) * src[i];
+    }
+    for (int y = 1; y <= radius; ++y) {
+        const quint8 *row = src + qMin(y, last) * bpl;
+        for (int i = 0; i < count; ++i) {
+            sum[i] += row[i];
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        quint8 *out = dst + y * bpl;
+        const quint8 *add = src + qMin(y + radius + 1, last) * bpl;
+        const quint8 *sub = src + qMax(y - radius, 0) * bpl;
+        for (int i = 0; i < count; ++i) {
+            out[i] = boxMean(sum[i], inv);
+            sum[i] += add[i] - sub[i];
+        }
+    }
+}
+
+#ifdef FX_SSE2
+inline __m128i sse2Mean(const __m128i &sum, const __m128 &inv) {
+    const __m128 f = _mm_add_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(0.5f));
+    return _mm_cvttps_epi32(_mm_mul_ps(f, inv));
+}
+
+// Horizontal pass over one row of ARGB32 pixels, a pixel per register
+void blurRowSse2(const quint8 *src, quint8 *dst, int width, int radius) {
+    const quint32 *in = (const quint32 *)src;
+    quint32 *out = (quint32 *)dst;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 inv = _mm_set1_ps(1.0f / (2 * radius + 1));
+    const int last = width - 1;
+    auto load = [&](int x) {
+        const __m128i v = _mm_cvtsi32_si128((int)in[x]);
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+    };
+    __m128i sum = zero;
+    for (int x = -radius; x <= radius; ++x) {
+        sum = _mm_add_epi32(sum, load(qBound(0, x, last)));
+    }
+    for (int x = 0; x < width; ++x) {
+        const __m128i mean = sse2Mean(sum, inv);
+        const __m128i packed = _mm_packs_epi32(mean, mean);
+        out[x] = (quint32)_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed));
+        sum = _mm_add_epi32(sum, load(qMin(x + radius + 1, last)));
+        sum = _mm_sub_epi32(sum, load(qMax(x - radius, 0)));
+    }
+}
+
+// As blurColumnsScalar(), 16 bytes at a time
+void blurColumnsSse2(const quint8 *src, quint8 *dst, qint64 bpl, int height,
+                     int radius, int begin, int end) {
+    const int simdEnd = begin + (end - begin) / 16 * 16;
+    if (simdEnd < end) {
+        blurColumnsScalar(src, dst, bpl, height, radius, simdEnd, end);
+    }
+    if (simdEnd == begin) {
+        return;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 inv = _mm_set1_ps(1.0f / (2 * radius + 1));
+    const int last = height - 1;
+    std::vector<quint32> sums(simdEnd - begin);
+    // Adds (or subtracts) 16 bytes to their sums
+    auto accumulate = [&zero](quint32 *sums, const quint8 *bytes, bool add) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)bytes);
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        const __m128i parts[4] = {
+            _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+            _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)};
+        for (int k = 0; k < 4; ++k) {
+            __m128i *sum = (__m128i *)sums + k;
+            const __m128i v = _mm_loadu_si128(sum);
+            _mm_storeu_si128(sum, add ? _mm_add_epi32(v, parts[k])
+                                      : _mm_sub_epi32(v, parts[k]));
+        }
+    };
+    for (int y = -radius; y <= radius; ++y) {
+        const quint8 *row = src + qBound(0, y, last) * bpl;
+        for (int i = begin; i < simdEnd; i += 16) {
+            accumulate(sums.data() + i - begin, row + i, true);
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        quint8 *out = dst + y * bpl;
+        const quint8 *add = src + qMin(y + radius + 1, last) * bpl;
+        const quint8 *sub = src + qMax(y - radius, 0) * bpl;
+        for (int i = begin; i < simdEnd; i += 16) {
+            quint32 *sum = sums.data() + i - begin;
+            __m128i means[4];
+            for (int k = 0; k < 4; ++k) {
+                means[k] = sse2Mean(
+                    _mm_loadu_si128((const __m128i *)sum + k), inv);
+            }
+            const __m128i lo = _mm_packs_epi32(means[0], means[1]);
+            const __m128i hi = _mm_packs_epi32(means[2], means[3]);
+            _mm_storeu_si128((__m128i *)(out + i), _mm_packus_epi16(lo, hi));
+            accumulate(sum, add + i, true);
+            accumulate(sum, sub + i, false);
+        }
+    }
+}
+#endif
+
+// Box widths of n passes approximating a Gaussian with the given sigma, see
+// http://blog.ivank.net/fastest-gaussian-blur.html
+QVector<int> gaussBoxes(double sigma, int n) {
+    const double wIdeal = sqrt((12.0 * sigma * sigma / n) + 1.0);
+    int wl = (int)floor(wIdeal);
+    if (wl % 2 == 0) {
+        wl--;
+    }
+    const int wu = wl + 2;
+    const double mIdeal =
+        (12.0 * sigma * sigma - n * wl * wl - 4.0 * n * wl - 3.0 * n) /
+        (-4.0 * wl - 4.0);
+    const int m = (int)round(mIdeal);
+    QVector<int> sizes;
+    for (int i = 0; i < n; ++i) {
+        sizes.append(i < m ? wl : wu);
+    }
+    return sizes;
+}
+
+// One horizontal and one vertical pass from image via tmp back to image
+void blurPass(QImage &image, QImage &tmp, const int radius, const bool sse2,
+              const bool parallel) {
+    const int bytesPerPixel = image.depth() / 8;
+    const int width = image.width();
+    const int height = image.height();
+    const qint64 bpl = image.bytesPerLine();
+    const quint8 *src = image.constBits();
+    quint8 *dst = tmp.bits();
+    forRanges(parallel, height, width, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            const quint8 *in = src + y * bpl;
+            quint8 *out = dst + y * bpl;
+            if (bytesPerPixel == 1) {
+                blurRowScalar<1>(in, out, width, radius);
+            } else {
+#ifdef FX_SSE2
+                if (sse2) {
+                    blurRowSse2(in, out, width, radius);
+                    continue;
+                }
+#endif
+                blurRowScalar<4>(in, out, width, radius);
+            }
+        }
+    });
+    src = tmp.constBits();
+    dst = image.bits();
+    // Strips of 16 bytes, as many as fit in MINCHUNK pixels
+    const int strips = (width * bytesPerPixel + 15) / 16;
+    const int rowBytes = width * bytesPerPixel;
+    forRanges(parallel, strips, 16 / bytesPerPixel * height,
+              [&](int begin, int end) {
+                  begin *= 16;
+                  end = qMin(end * 16, rowBytes);
+#ifdef FX_SSE2
+                  if (sse2) {
+                      blurColumnsSse2(src, dst, bpl, height, radius, begin,
+                                      end);
+                      return;
+                  }
+#endif
+                  blurColumnsScalar(src, dst, bpl, height, radius, begin,
+                                    end);
+              });
+}
+} // namespace
+
+FxKernels::Isa FxKernels::isa = FxKernels::bestIsa();
+
+bool FxKernels::isSupported(const Isa isa) {
+    switch (isa) {
+    case ISA_SCALAR:
+        return true;
+#ifdef FX_SSE2
+    case ISA_SSE2:
+        return true;
+#endif
+#ifdef FX_AVX2
+    case ISA_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#ifdef FX_NEON
+    case ISA_NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+FxKernels::Isa FxKernels::bestIsa() {
+    for (const auto candidate : {ISA_AVX2, ISA_SSE2, ISA_NEON}) {
+        if (isSupported(candidate)) {
+            return candidate;
+        }
+    }
+    return ISA_SCALAR;
+}
+
+bool FxKernels::parallel = true;
+
+FxKernels::Isa FxKernels::getIsa() { return isa; }
+
+void FxKernels::setIsa(const Isa isa) {
+    if (isSupported(isa)) {
+        FxKernels::isa = isa;
+    }
+}
+
+void FxKernels::setParallel(const bool enabled) { parallel = enabled; }
+
+void FxKernels::scaleOffset(QImage &image, const int mul[4],
+                            const int offset[3]) {
+    Params p;
+    // QRgb is blue, green, red, alpha from the lowest byte up
+    const int order[4] = {2, 1, 0, 3};
+    for (int c = 0; c < 4; ++c) {
+        const int src = order[c];
+        p.mul[c] = (quint16)qBound(0, mul[src], src == 3 ? 256 : 65535);
+        const int off = src == 3 ? 0 : qBound(-255, offset[src], 255);
+        p.pos[c] = (quint16)qMax(0, off);
+        p.neg[c] = (quint16)qMax(0, -off);
+    }
+    const LineKernel kernel = scaleOffsetKernel(isa);
+    forRows(image, parallel, [&p, kernel](QRgb *line, int width) {
+        kernel((quint32 *)line, width, p);
+    });
+}
+
+void FxKernels::hue(QImage &image, const int delta) {
+    mapStraight(image, parallel, [delta](QRgb v) {
+        const int r = qRed(v), g = qGreen(v), b = qBlue(v);
+        const int max = qMax(r, qMax(g, b));
+        const int range = max - qMin(r, qMin(g, b));
+        if (range == 0) {
+            return v;
+        }
+        // As QColor::saturation() and hue(), both truncated to integers
+        const int s = ((2 * range * 65535 + max) / (2 * max)) >> 8;
+        const int h = hue100(r, g, b, max, range) / 100;
+        return fromHsv((h + delta) % 360, s, max, qAlpha(v));
+    });
+}
+
+void FxKernels::saturation(QImage &image, const int delta) {
+    mapStraight(image, parallel, [delta](QRgb v) {
+        const int r = qRed(v), g = qGreen(v), b = qBlue(v);
+        const int max = qMax(r, qMax(g, b));
+        const int min = qMin(r, qMin(g, b));
+        const int range = max - min;
+        if (range == 0) {
+            // Achromatic, QColor keeps the grey whatever the saturation
+            return v;
+        }
+        const int sum = max + min;
+        const int l = ((sum * 257 + 1) / 2) >> 8;
+        const int div = sum < 255 ? sum : 510 - sum;
+        const int s = ((2 * range * 65535 + div) / (2 * div)) >> 8;
+        const int h = hue100(r, g, b, max, range) / 100;
+        return fromHsl(h, qBound(0, s + delta, 255), l, qAlpha(v));
+    });
+}
+
+void FxKernels::colorize(QImage &image, const int hue,
+                         const int saturation) {
+    // The colour only depends on the lightness
+    QRgb lut[256];
+    for (int l = 0; l < 256; ++l) {
+        QColor color;
+        color.setHsl(hue, saturation, l);
+        lut[l] = color.rgb() & RGB_MASK;
+    }
+    mapStraight(image, parallel, [&lut](QRgb v) {
+        // https://en.wikipedia.org/wiki/Grayscale#Colorimetric_(perceptual_luminance-preserving)_conversion_to_grayscale
+        const int l =
+            qRed(v) * 0.2126 + qGreen(v) * 0.7152 + qBlue(v) * 0.0722;
+        return lut[l] | (v & ~RGB_MASK);
+    });
+}
+
+void FxKernels::boxBlur(QImage &image, const int radius, const bool gaussian) {
+    if (image.format() != QImage::Format_Alpha8 &&
+        image.format() != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+    if (radius <= 0 || image.isNull()) {
+        return;
+    }
+    QVector<int> radii = {qMin(radius, MAXBLURRADIUS)};
+    if (gaussian) {
+        // Same standard deviation as the single box
+        const double span = 2 * radii.first() + 1;
+        radii.clear();
+        for (const int width :
+             gaussBoxes(sqrt((span * span - 1.0) / 12.0), 3)) {
+            radii.append(qMin((width - 1) / 2, MAXBLURRADIUS));
+        }
+    }
+#ifdef FX_SSE2
+    const bool sse2 = isa == ISA_SSE2 || isa == ISA_AVX2;
+#else
+    const bool sse2 = false;
+#endif
+    QImage tmp(image.size(), image.format());
+    for (const int r : radii) {
+        if (r > 0) {
+            blurPass(image, tmp, r, sse2, parallel);
+        }
+    }
+}
+
+void FxKernels::applyLut(QImage &image, const QImage &lut) {
+    const uchar *table = lut.constBits();
+    const qint64 tableBpl = lut.bytesPerLine();
+    forRows(image, parallel, [table, tableBpl](QRgb *line, int width) {
+        for (int x = 0; x < width; ++x) {
+            const QRgb v = line[x];
+            const QRgb *row = (const QRgb *)(table + qAlpha(v) * tableBpl);
+            line[x] = (row[0] & 0xff000000) | (row[qRed(v)] & 0x00ff0000) |
+                      (row[qGreen(v)] & 0x0000ff00) |
+                      (row[qBlue(v)] & 0x000000ff);
+        }
+    });
+}
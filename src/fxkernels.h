@@ -0,0 +1,76 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef FXKERNELS_H
+#define FXKERNELS_H
+
+#include <QImage>
+
+// Per pixel kernels of the colour effects. They work in place on
+// premultiplied ARGB32, large images are split into row ranges that run on
+// the global thread pool. scaleOffset() has SSE2, AVX2 or NEON code picked
+// at runtime, boxBlur() SSE2, both with a scalar fallback. All code paths
+// give bit identical results.
+class FxKernels {
+public:
+    enum Isa { ISA_SCALAR, ISA_SSE2, ISA_AVX2, ISA_NEON };
+
+    // Red, green and blue become p * mul / 256 + offset * alpha / 255,
+    // clamped to [0, alpha], and alpha becomes alpha * mul / 256. On
+    // premultiplied pixels this is the same as scaling and offsetting the
+    // straight colour, translucent pixels are not darkened. Values are given
+    // as red, green, blue (, alpha), mul is [0, 65535] for the colours and
+    // [0, 256] for alpha. Don't combine an alpha mul with offsets
+    static void scaleOffset(QImage &image, const int mul[4],
+                            const int offset[3]);
+    // Fixed point versions of the QColor HSV and HSL round trips, they give
+    // the QColor results within 1 per channel. All of them work on the
+    // straight colour and keep alpha
+    // Adds delta [0, 359] degrees to the HSV hue
+    static void hue(QImage &image, const int delta);
+    // Adds delta to the HSL saturation, clamped to [0, 255]
+    static void saturation(QImage &image, const int delta);
+    // Sets HSL hue [0, 359] and saturation [0, 255], the lightness is the
+    // luminance of the pixel
+    static void colorize(QImage &image, const int hue, const int saturation);
+    // Box blur of premultiplied ARGB32 or Alpha8 images, pixels beyond the
+    // edges repeat the edge pixels. With gaussian it does three box passes
+    // that approximate a Gaussian with the spread of the single box
+    static void boxBlur(QImage &image, const int radius,
+                        const bool gaussian = false);
+    // Replaces every channel by its entry in lut. Row a, column p of lut
+    // holds the result for alpha a and channel value p of any chain of
+    // effects that treats each channel on its own (scaleOffset())
+    static void applyLut(QImage &image, const QImage &lut);
+
+    static bool isSupported(const Isa isa);
+    static Isa getIsa();
+    // Forces a code path, for tests and benchmarks. Unsupported ones are
+    // ignored
+    static void setIsa(const Isa isa);
+    // Turns the row parallel execution on or off, it is on by default
+    static void setParallel(const bool enabled);
+
+private:
+    static Isa bestIsa();
+    static Isa isa;
+    static bool parallel;
+};
+
+#endif // FXKERNELS_H
@@ -25,42 +25,55 @@
 
 #include "fxmask.h"
 
+#include "imgtools.h"
+
 #include <QPainter>
 #include <cmath>
 
 FxMask::FxMask() {}
 
-QImage FxMask::applyEffect(const QImage &src, const Layer &layer,
+QImage FxMask::applyEffect(QImage canvas, const Layer &layer,
                            Settings *config) {
-    QImage canvas = src;
-
-    QImage mask(config->resources[layer.resource]);
-    mask = mask.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-
-    if (layer.width == -1 && layer.height == -1) {
-        mask = mask.scaled(src.width(), src.height(), Qt::IgnoreAspectRatio,
-                           Qt::SmoothTransformation);
-    } else if (layer.width == -1 && layer.height != -1) {
-        mask = mask.scaledToHeight(layer.height, Qt::SmoothTransformation);
-    } else if (layer.width != -1 && layer.height == -1) {
-        mask = mask.scaledToWidth(layer.width, Qt::SmoothTransformation);
-    } else if (layer.width != -1 && layer.height != -1) {
-        mask = mask.scaled(layer.width, layer.height, layer.aspect,
-                           Qt::SmoothTransformation);
-    }
+    // Only depends on the resource and the target size, not on the game
+    const QString key = QString("mask:%1:%2x%3:%4x%5:%6")
+                            .arg(layer.resource)
+                            .arg(canvas.width())
+                            .arg(canvas.height())
+                            .arg(layer.width)
+                            .arg(layer.height)
+                            .arg((int)layer.aspect);
+    const QImage mask = ImgTools::derived(key, [&]() {
+        QImage scaled = config->resources.value(layer.resource);
+        if (layer.width == -1 && layer.height == -1) {
+            scaled = scaled.scaled(canvas.width(), canvas.height(),
+                                   Qt::IgnoreAspectRatio,
+                                   Qt::SmoothTransformation);
+        } else if (layer.width == -1 && layer.height != -1) {
+            scaled =
+                scaled.scaledToHeight(layer.height, Qt::SmoothTransformation);
+        } else if (layer.width != -1 && layer.height == -1) {
+            scaled =
+                scaled.scaledToWidth(layer.width, Qt::SmoothTransformation);
+        } else if (layer.width != -1 && layer.height != -1) {
+            scaled = scaled.scaled(layer.width, layer.height, layer.aspect,
+                                   Qt::SmoothTransformation);
+        }
+        return scaled;
+    });
 
     QPainter painter;
     painter.begin(&canvas);
     painter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
     painter.drawImage(layer.x, layer.y, mask);
     painter.setCompositionMode(QPainter::CompositionMode_DestinationOut);
-    painter.fillRect(0, 0, layer.x, src.height(), QColor(0, 0, 0));
-    painter.fillRect(0, 0, src.width(), layer.y, QColor(0, 0, 0));
+    painter.fillRect(0, 0, layer.x, canvas.height(), QColor(0, 0, 0));
+    painter.fillRect(0, 0, canvas.width(), layer.y, QColor(0, 0, 0));
     painter.fillRect(layer.x + mask.width(), 0,
-                     src.width() - layer.x - mask.width(), src.height(),
+                     canvas.width() - layer.x - mask.width(), canvas.height(),
+                     QColor(0, 0, 0));
+    painter.fillRect(0, layer.y + mask.height(), canvas.width(),
+                     canvas.height() - layer.y - mask.height(),
                      QColor(0, 0, 0));
-    painter.fillRect(0, layer.y + mask.height(), src.width(),
-                     src.height() - layer.y - mask.height(), QColor(0, 0, 0));
     painter.end();
 
     return canvas;
@@ -36,7 +36,7 @@ class FxMask : public QObject {
 
 public:
     FxMask();
-    QImage applyEffect(const QImage &src, const Layer &layer, Settings *config);
+    QImage applyEffect(QImage canvas, const Layer &layer, Settings *config);
 };
 
 #endif // FXMASK_H
@@ -25,22 +25,15 @@
 
 #include "fxopacity.h"
 
-#include <QPainter>
-#include <cmath>
+#include "fxkernels.h"
 
 FxOpacity::FxOpacity() {}
 
-QImage FxOpacity::applyEffect(const QImage &src, const Layer &layer) {
-    double opacity = layer.opacity;
-
-    QImage canvas(src.width(), src.height(),
-                  QImage::Format_ARGB32_Premultiplied);
-    canvas.fill(Qt::transparent);
-    QPainter painter;
-    painter.begin(&canvas);
-    painter.setOpacity(opacity / 100.0);
-    painter.drawImage(0, 0, src);
-    painter.end();
+QImage FxOpacity::applyEffect(QImage canvas, const Layer &layer) {
+    const int scale = qRound(layer.opacity * 256 / 100.0);
+    const int mul[4] = {scale, scale, scale, scale};
+    const int offset[3] = {0, 0, 0};
+    FxKernels::scaleOffset(canvas, mul, offset);
 
     return canvas;
 }
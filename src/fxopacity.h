@@ -36,7 +36,7 @@ class FxOpacity : public QObject {
 
 public:
     FxOpacity();
-    QImage applyEffect(const QImage &src, const Layer &layer);
+    QImage applyEffect(QImage canvas, const Layer &layer);
 };
 
 #endif // FXOPACITY_H
@@ -25,28 +25,37 @@
 
 #include "fxrounded.h"
 
+#include "imgtools.h"
+
 #include <QPainter>
 #include <QPainterPath>
 
 FxRounded::FxRounded() {}
 
-QImage FxRounded::applyEffect(const QImage &src, const Layer &layer) {
-    QImage canvas = src;
+QImage FxRounded::applyEffect(QImage canvas, const Layer &layer) {
+    const QImage mask = ImgTools::derived(
+        QString("rounded:%1x%2:%3")
+            .arg(canvas.width())
+            .arg(canvas.height())
+            .arg(layer.width),
+        [&]() {
+            QImage image(canvas.width(), canvas.height(),
+                         QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::transparent);
 
-    QImage mask(src.width(), src.height(), QImage::Format_ARGB32_Premultiplied);
-    mask.fill(Qt::transparent);
+            QPainter painter;
+            painter.begin(&image);
+            painter.setRenderHint(QPainter::Antialiasing);
+            QPainterPath path;
+            path.addRoundedRect(0, 0, canvas.width(), canvas.height(),
+                                layer.width, layer.width);
+            painter.fillPath(path, Qt::black);
+            painter.drawPath(path);
+            painter.end();
+            return image;
+        });
 
     QPainter painter;
-
-    painter.begin(&mask);
-    painter.setRenderHint(QPainter::Antialiasing);
-    QPainterPath path;
-    path.addRoundedRect(0, 0, src.width(), src.height(), layer.width,
-                        layer.width);
-    painter.fillPath(path, Qt::black);
-    painter.drawPath(path);
-    painter.end();
-
     painter.begin(&canvas);
     painter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
     painter.drawImage(0, 0, mask);
@@ -36,7 +36,7 @@ class FxRounded : public QObject {
 
 public:
     FxRounded();
-    QImage applyEffect(const QImage &src, const Layer &layer);
+    QImage applyEffect(QImage canvas, const Layer &layer);
 };
 
 #endif // FXROUNDED_H
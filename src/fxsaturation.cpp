@@ -25,36 +25,14 @@
 
 #include "fxsaturation.h"
 
-#include <QPainter>
-#include <cmath>
+#include "fxkernels.h"
 
 FxSaturation::FxSaturation() {}
 
-QImage FxSaturation::applyEffect(const QImage &src, const Layer &layer) {
-    QImage canvas = src;
-
+QImage FxSaturation::applyEffect(QImage canvas, const Layer &layer) {
     int saturation = layer.delta;
 
-    for (int y = 0; y < canvas.height(); ++y) {
-        QRgb *line = (QRgb *)canvas.scanLine(y);
-        for (int x = 0; x < canvas.width(); ++x) {
-            QColor color(line[x]);
-            color.setHsl(color.hue(),
-                         truncate(color.hslSaturation() + saturation),
-                         color.lightness(), qAlpha(line[x]));
-            line[x] = qPremultiply(color.rgba());
-        }
-    }
+    FxKernels::saturation(canvas, saturation);
 
     return canvas;
 }
-
-int FxSaturation::truncate(int value) {
-    if (value > 255) {
-        value = 255;
-    }
-    if (value < 0) {
-        value = 0;
-    }
-    return value;
-}
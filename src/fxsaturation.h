@@ -36,10 +36,7 @@ class FxSaturation : public QObject {
 
 public:
     FxSaturation();
-    QImage applyEffect(const QImage &src, const Layer &layer);
-
-private:
-    int truncate(int value);
+    QImage applyEffect(QImage canvas, const Layer &layer);
 };
 
 #endif // FXSATURATION_H
@@ -25,14 +25,15 @@
 
 #include "fxscanlines.h"
 
+#include "imgtools.h"
+
 #include <QPainter>
 #include <cmath>
 
 FxScanlines::FxScanlines() {}
 
-QImage FxScanlines::applyEffect(const QImage &src, const Layer &layer,
+QImage FxScanlines::applyEffect(QImage canvas, const Layer &layer,
                                 Settings *config) {
-    QImage canvas = src;
     QString resource = layer.resource;
     double scaling = 1.0;
     int opacity = layer.opacity;
@@ -70,17 +71,20 @@ QImage FxScanlines::applyEffect(const QImage &src, const Layer &layer,
     }
     */
 
+    const QImage scanlines = ImgTools::derived(
+        QString("scanlines:%1:%2").arg(resource).arg(scaling), [&]() {
+            const QImage image = config->resources.value(resource);
+            return scaling != 1.0
+                       ? image.scaledToWidth(
+                             (int)((double)image.width() * scaling),
+                             Qt::FastTransformation)
+                       : image;
+        });
     QPainter painter;
     painter.begin(&canvas);
     painter.setOpacity(opacity * 0.01);
     painter.setCompositionMode(layer.mode);
-    painter.drawImage(
-        0, 0,
-        (scaling != 1.0
-             ? config->resources[resource].scaledToWidth(
-                   (int)((double)config->resources[resource].width() * scaling),
-                   Qt::FastTransformation)
-             : config->resources[resource]));
+    painter.drawImage(0, 0, scanlines);
     painter.end();
 
     return canvas;
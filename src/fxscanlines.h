@@ -36,7 +36,7 @@ class FxScanlines : public QObject {
 
 public:
     FxScanlines();
-    QImage applyEffect(const QImage &src, const Layer &layer, Settings *config);
+    QImage applyEffect(QImage canvas, const Layer &layer, Settings *config);
 };
 
 #endif // FXSCANLINES_H
@@ -26,7 +26,89 @@
 #include "fxstroke.h"
 
 #include <QPainter>
+#include <QVector>
 #include <cmath>
+#include <limits>
+
+namespace {
+// Maximum of the window [i - radius, i + radius] for all n values at
+// stride step, outside values are 0. Van Herk / Gil-Werman: with blocks of
+// the window size every window is the suffix maximum of one block and the
+// prefix maximum of the next, three comparisons per value for any radius
+void maxFilter(quint8 *data, int n, qint64 step, int radius,
+               QVector<quint8> &prefix, QVector<quint8> &suffix) {
+    const int k = 2 * radius + 1;
+    // Values with radius zeros on both sides, window i is [i, i + k - 1]
+    const int m = n + 2 * radius;
+    prefix.resize(m);
+    suffix.resize(m);
+    auto value = [&](int j) -> quint8 {
+        return j < radius || j >= radius + n ? 0 : data[(j - radius) * step];
+    };
+    for (int j = 0; j < m; ++j) {
+        prefix[j] = j % k == 0 ? value(j) : qMax(prefix[j - 1], value(j));
+    }
+    for (int j = m - 1; j >= 0; --j) {
+        suffix[j] = (j + 1) % k == 0 || j == m - 1
+                        ? value(j)
+                        : qMax(suffix[j + 1], value(j));
+    }
+    for (int i = 0; i < n; ++i) {
+        data[i * step] = qMax(suffix[i], prefix[i + k - 1]);
+    }
+}
+
+// Squared distance to the nearest zero of f along n values at stride step,
+// Felzenszwalb / Huttenlocher lower envelope of parabolas
+void distance1d(float *f, int n, qint64 step, QVector<float> &tmp,
+                QVector<int> &v, QVector<float> &z) {
+    tmp.resize(n);
+    v.resize(n);
+    z.resize(n + 1);
+    for (int q = 0; q < n; ++q) {
+        tmp[q] = f[q * step];
+    }
+    const float inf = std::numeric_limits<float>::infinity();
+    int k = 0;
+    v[0] = 0;
+    z[0] = -inf;
+    z[1] = inf;
+    for (int q = 1; q < n; ++q) {
+        if (tmp[q] == inf) {
+            continue;
+        }
+        float s;
+        while (true) {
+            const int p = v[k];
+            s = tmp[p] == inf
+                    ? -inf
+                    : ((tmp[q] + q * q) - (tmp[p] + p * p)) / (2 * (q - p));
+            if (s > z[k] || k == 0) {
+                break;
+            }
+            --k;
+        }
+        if (tmp[v[k]] == inf) {
+            // Only the first value may be infinite, replace it
+            v[k] = q;
+            z[k] = -inf;
+        } else {
+            ++k;
+            v[k] = q;
+            z[k] = s;
+        }
+        z[k + 1] = inf;
+    }
+    k = 0;
+    for (int q = 0; q < n; ++q) {
+        while (z[k + 1] < q) {
+            ++k;
+        }
+        const float d = q - v[k];
+        f[q * step] = tmp[v[k]] == inf ? inf : d * d + tmp[v[k]];
+    }
+}
+} // namespace
 
 FxStroke::FxStroke() {}
 
@@ -65,55 +147,80 @@ QImage FxStroke::applyEffect(const QImage &src, const Layer &layer) {
             blue = 0;
     }
 
-    QImage buffer1(src.width() + layer.width * 2,
-                   src.height() + layer.width * 2,
-                   QImage::Format_ARGB32_Premultiplied);
-    buffer1.fill(Qt::transparent);
-    QPainter painter;
-    painter.begin(&buffer1);
-    painter.drawImage(layer.width, layer.width, src);
-    painter.end();
-
-    QImage buffer2(src.width() + layer.width * 2,
-                   src.height() + layer.width * 2,
-                   QImage::Format_ARGB32_Premultiplied);
-    buffer2.fill(Qt::transparent);
-
-    QRgb *buffer1Bits = (QRgb *)buffer1.bits();
-    QRgb *buffer2Bits = (QRgb *)buffer2.bits();
+    // A negative width from the xml draws no stroke, like a zero one
+    const int radius = qMax(0, layer.width);
+    const int width = src.width() + radius * 2;
+    const int height = src.height() + radius * 2;
+    const QImage source =
+        src.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QVector<quint8> alpha(width * height, 0);
+    for (int y = 0; y < source.height(); ++y) {
+        const QRgb *line = (const QRgb *)source.constScanLine(y);
+        quint8 *out = alpha.data() + (y + radius) * width + radius;
+        for (int x = 0; x < source.width(); ++x) {
+            out[x] = qAlpha(line[x]);
+        }
+    }
 
-    int width = buffer1.width();
-    int height = buffer1.height();
+    if (radius == 0) {
+        alpha.fill(0);
+    } else if (layer.antialias) {
+        antialiasedOutline(alpha, width, height, radius);
+    } else {
+        squareOutline(alpha, width, height, radius);
+    }
 
-    // Now dilate each pixel 'layer.width' number of times
-    for (int a = 0; a < layer.width; ++a) {
-        for (int y = 0; y < height; ++y) {
-            for (int x = 0; x < width; ++x) {
-                int alpha = qAlpha(buffer1Bits[y * width + x]);
-                if (alpha != 0) {
-                    for (int i = -1; i <= 1; ++i) {
-                        for (int j = -1; j <= 1; ++j) {
-                            if (qAlpha(buffer2Bits[(y + i) * width + x + j]) <
-                                alpha) {
-                                buffer2Bits[(y + i) * width + x + j] =
-                                    qPremultiply(
-                                        qRgba(red, green, blue, alpha));
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        for (int y = 0; y < height; ++y) {
-            for (int x = 0; x < width; ++x) {
-                buffer1Bits[y * width + x] = buffer2Bits[y * width + x];
-            }
+    QImage buffer2(width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = (QRgb *)buffer2.scanLine(y);
+        const quint8 *in = alpha.constData() + y * width;
+        for (int x = 0; x < width; ++x) {
+            line[x] = qPremultiply(qRgba(red, green, blue, in[x]));
         }
     }
 
+    QPainter painter;
     painter.begin(&buffer2);
-    painter.drawImage(layer.width, layer.width, src);
+    painter.drawImage(radius, radius, src);
     painter.end();
 
     return buffer2;
 }
+
+void FxStroke::squareOutline(QVector<quint8> &alpha, int width, int height,
+                             int radius) {
+    // Dilating 'radius' times with a 3x3 square is the maximum over a square
+    // window, which is separable into a row and a column pass
+    QVector<quint8> prefix, suffix;
+    for (int y = 0; y < height; ++y) {
+        maxFilter(alpha.data() + y * width, width, 1, radius, prefix, suffix);
+    }
+    for (int x = 0; x < width; ++x) {
+        maxFilter(alpha.data() + x, height, width, radius, prefix, suffix);
+    }
+}
+
+void FxStroke::antialiasedOutline(QVector<quint8> &alpha, int width,
+                                  int height, int radius) {
+    // Euclidean distance to the nearest mostly opaque pixel. Its edge is half
+    // a pixel from its centre, so the outline ends at radius + 0.5 and a
+    // pixel centred at d is covered by about radius + 1 - d
+    const float inf = std::numeric_limits<float>::infinity();
+    QVector<float> distance(width * height);
+    for (int i = 0; i < distance.size(); ++i) {
+        distance[i] = alpha.at(i) >= 128 ? 0.0f : inf;
+    }
+    QVector<float> tmp, z;
+    QVector<int> v;
+    for (int x = 0; x < width; ++x) {
+        distance1d(distance.data() + x, height, width, tmp, v, z);
+    }
+    for (int y = 0; y < height; ++y) {
+        distance1d(distance.data() + y * width, width, 1, tmp, v, z);
+    }
+    for (int i = 0; i < alpha.size(); ++i) {
+        const float coverage =
+            qBound(0.0f, radius + 1.0f - std::sqrt(distance.at(i)), 1.0f);
+        alpha[i] = qMax(alpha.at(i), (quint8)qRound(coverage * 255.0f));
+    }
+}
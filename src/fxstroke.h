@@ -30,6 +30,7 @@
 
 #include <QImage>
 #include <QObject>
+#include <QVector>
 
 class FxStroke : public QObject {
     Q_OBJECT
@@ -37,6 +38,12 @@ class FxStroke : public QObject {
 public:
     FxStroke();
     QImage applyEffect(const QImage &src, const Layer &layer);
+
+private:
+    void squareOutline(QVector<quint8> &alpha, int width, int height,
+                       int radius);
+    void antialiasedOutline(QVector<quint8> &alpha, int width, int height,
+                            int radius);
 };
 
 #endif // FXSTROKE_H
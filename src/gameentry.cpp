@@ -82,7 +82,7 @@ void GameEntry::calculateCompleteness(bool videoEnabled, bool manualEnabled) {
     if (videoEnabled && videoFormat.isEmpty()) {
         completeness -= valuePerType;
     }
-    if (manualEnabled && manualData.isEmpty()) {
+    if (manualEnabled && manualData.isEmpty() && manualFile.isEmpty()) {
         completeness -= valuePerType;
     }
 }
@@ -97,4 +97,6 @@ void GameEntry::resetMedia() {
     textureData.clear();
     videoData.clear();
     manualData.clear();
+    cacheFiles.clear();
+    imageInfos.clear();
 }
@@ -26,6 +26,8 @@
 #ifndef GAMEENTRY_H
 #define GAMEENTRY_H
 
+#include "imgtools.h"
+
 #include <QByteArray>
 #include <QList>
 #include <QMap>
@@ -120,6 +122,12 @@ public:
     QString baseName = "";
     QString absoluteFilePath = "";
     bool found = true;
+    // Cache file the data of each binary type was read from, by type. Set
+    // by Cache::fillBlanks
+    QMap<QString, QString> cacheFiles;
+    // What the cache knows of the images above, by type. Invalid where it
+    // doesn't
+    QMap<QString, ImageInfo> imageInfos;
 
     // used by mobygames
     QByteArray miscData = "";
@@ -69,10 +69,7 @@ Igdb::Igdb(Settings *config, QSharedPointer<NetManager> manager)
     fetchOrder.append(COVER);
 }
 
-void Igdb::getSearchResults(QList<GameEntry> &gameEntries, QString searchName,
-                            QString platform) {
-
-    limiter.exec();
+QString Igdb::searchQuery(const QString &searchName) {
     const QStringList fields = {
         // clang-format off
         "game.name",
@@ -96,15 +93,54 @@ void Igdb::getSearchResults(QList<GameEntry> &gameEntries, QString searchName,
         clause = QString("where game = %1").arg(gameId);
     }
 
-    const QString postData =
-        QString("fields %1; %2 & game.version_parent = null;")
-            .arg(fields.join(","))
-            .arg(clause);
-    qDebug() << baseUrl + "/search/";
+    return QString("fields %1; %2 & game.version_parent = null;")
+        .arg(fields.join(","))
+        .arg(clause);
+}
+
+void Igdb::getBatchResults(const QStringList &searchNames,
+                           QMap<QString, QByteArray> &results) {
+    limiter.exec();
+    // One named sub-query per search name, the reply holds the result of
+    // each sub-query under its name
+    QString postData;
+    for (int i = 0; i < searchNames.size(); ++i) {
+        postData.append(QString("query search \"%1\" { %2 };\n")
+                            .arg(QString::number(i))
+                            .arg(searchQuery(searchNames.at(i))));
+    }
+    qDebug() << baseUrl + "/multiquery";
     qDebug() << postData;
-    netComm->request(baseUrl + "/search/", postData, headers);
+    netComm->request(baseUrl + "/multiquery", postData, headers);
     q.exec();
-    data = netComm->getData();
+
+    // A throttled or failed batch returns no array, each name is then
+    // looked up on its own
+    QJsonArray jsonQueries =
+        QJsonDocument::fromJson(netComm->getData()).array();
+    for (const auto &jsonQuery : jsonQueries) {
+        bool ok;
+        int i = jsonQuery.toObject()["name"].toString().toInt(&ok);
+        if (ok && i >= 0 && i < searchNames.size()) {
+            results.insert(
+                searchNames.at(i),
+                QJsonDocument(jsonQuery.toObject()["result"].toArray())
+                    .toJson(QJsonDocument::Compact));
+        }
+    }
+}
+
+void Igdb::getSearchResults(QList<GameEntry> &gameEntries, QString searchName,
+                            QString platform) {
+    if (!takeBatchResult(searchName, data)) {
+        limiter.exec();
+        const QString postData = searchQuery(searchName);
+        qDebug() << baseUrl + "/search/";
+        qDebug() << postData;
+        netComm->request(baseUrl + "/search/", postData, headers);
+        q.exec();
+        data = netComm->getData();
+    }
 
     jsonDoc = QJsonDocument::fromJson(data);
     if (jsonDoc.isEmpty()) {
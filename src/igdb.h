@@ -37,6 +37,8 @@ class Igdb : public AbstractScraper {
 
 public:
     Igdb(Settings *config, QSharedPointer<NetManager> manager);
+    // Max. number of sub-queries of one multiquery request
+    int getBatchSize() override { return 10; }
 
 private:
     QTimer limitTimer;
@@ -46,6 +48,9 @@ private:
 
     void getSearchResults(QList<GameEntry> &gameEntries, QString searchName,
                           QString platform) override;
+    void getBatchResults(const QStringList &searchNames,
+                         QMap<QString, QByteArray> &results) override;
+    QString searchQuery(const QString &searchName);
     void getGameData(GameEntry &game) override;
     void getReleaseDate(GameEntry &game) override;
     void getPlayers(GameEntry &game) override;
@@ -0,0 +1,134 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include "imagewriter.h"
+
+#include <QDebug>
+#include <QImageWriter>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+namespace {
+QThreadPool &pool() {
+    // Own pool, the global one is busy compositing
+    static QThreadPool encoders;
+    return encoders;
+}
+
+int maxQueued = 2 * qMax(1, QThread::idealThreadCount());
+
+// Bounds the memory held by images waiting for an encoder
+QSemaphore &queueSlots() {
+    static QSemaphore free(maxQueued);
+    return free;
+}
+
+QMutex failedMutex;
+QStringList failed;
+
+class EncodeTask : public QRunnable {
+public:
+    EncodeTask(const QImage &image, const QString &filename,
+               const QByteArray &format, const int compression,
+               const int quality, const std::function<void(bool)> &written)
+        : image(image), filename(filename), format(format),
+          compression(compression), quality(quality), written(written) {}
+    void run() override {
+        // Written next to the target and renamed over it, so a failure
+        // leaves earlier artwork intact
+        QSaveFile file(filename);
+        QImageWriter writer(&file, format);
+        if (format == "png") {
+            // Qt's PNG writer derives the zlib level from the quality as
+            // (100 - quality) * 9 / 91, this is its inverse
+            if (compression >= 0) {
+                writer.setQuality(100 - (qMin(compression, 9) * 91 + 8) / 9);
+            }
+        } else if (quality >= 0) {
+            writer.setQuality(qMin(quality, 100));
+        }
+        bool ok = file.open(QIODevice::WriteOnly);
+        QString error = file.errorString();
+        if (ok && !writer.write(image)) {
+            ok = false;
+            error = writer.errorString();
+        }
+        if (ok && !file.commit()) {
+            ok = false;
+            error = file.errorString();
+        }
+        if (!ok) {
+            qWarning() << "Could not write" << filename << "-" << error;
+            QMutexLocker locker(&failedMutex);
+            failed.append(filename);
+        }
+        image = QImage();
+        if (written) {
+            written(ok);
+        }
+        queueSlots().release();
+    }
+
+private:
+    QImage image;
+    QString filename;
+    QByteArray format;
+    int compression;
+    int quality;
+    std::function<void(bool)> written;
+};
+} // namespace
+
+void ImageWriter::write(const QImage &image, const QString &filename,
+                        const QByteArray &format, const int compression,
+                        const int quality,
+                        const std::function<void(bool)> &written) {
+    queueSlots().acquire();
+    pool().start(new EncodeTask(image, filename, format, compression, quality,
+                                written));
+}
+
+QStringList ImageWriter::waitForDone() {
+    pool().waitForDone();
+    QMutexLocker locker(&failedMutex);
+    QStringList files;
+    files.swap(failed);
+    return files;
+}
+
+void ImageWriter::setMaxQueued(const int images) {
+    // All slots are free once nothing is queued
+    pool().waitForDone();
+    const int change = qMax(1, images) - maxQueued;
+    if (change > 0) {
+        queueSlots().release(change);
+    } else {
+        queueSlots().acquire(-change);
+    }
+    maxQueued += change;
+}
+
+bool ImageWriter::isSupported(const QByteArray &format) {
+    return QImageWriter::supportedImageFormats().contains(format);
+}
@@ -0,0 +1,51 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef IMAGEWRITER_H
+#define IMAGEWRITER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+namespace ImageWriter {
+    // Queues image to be encoded and written to filename by a background
+    // pool, so compositing can go on with the next game meanwhile. format is
+    // a Qt image format name, compression the zlib level 0-9 of PNG and
+    // quality 0-100 of lossy formats, -1 keeps Qt's default. Blocks while too
+    // many images are waiting for an encoder. The file is replaced only once
+    // it is written completely, written is then called from the encoder
+    // thread with the outcome
+    void write(const QImage &image, const QString &filename,
+               const QByteArray &format, const int compression,
+               const int quality,
+               const std::function<void(bool)> &written = nullptr);
+    // Waits for all queued images to be written, returns the files that
+    // failed
+    QStringList waitForDone();
+    // Number of images that may wait for an encoder before write() blocks,
+    // twice the ideal thread count by default
+    void setMaxQueued(const int images);
+    bool isSupported(const QByteArray &format);
+} // namespace ImageWriter
+
+#endif // IMAGEWRITER_H
@@ -25,40 +25,245 @@
 
 #include "imgtools.h"
 
+#include <QBuffer>
+#include <QImageReader>
+#include <QMutexLocker>
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+#if defined(__SSE2__) || defined(_M_X64)
+#define IMG_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define IMG_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+// Size of the derived image cache in KiB
+constexpr int DERIVEDCACHESIZE = 128 * 1024;
+
+namespace {
+// Content is any not fully transparent pixel, with cropBlack it must not be
+// black either
+inline bool isContent(QRgb pixel, bool cropBlack) {
+    return (pixel & 0xff000000) && (!cropBlack || (pixel & 0x00ffffff));
+}
+
+#ifdef IMG_SSE2
+// Bit mask of the content pixels among four
+inline int sse2Content(const QRgb *pixels, bool cropBlack) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i v = _mm_loadu_si128((const __m128i *)pixels);
+    __m128i empty =
+        _mm_cmpeq_epi32(_mm_and_si128(v, _mm_set1_epi32((int)0xff000000)), zero);
+    if (cropBlack) {
+        empty = _mm_or_si128(
+            empty, _mm_cmpeq_epi32(
+                       _mm_and_si128(v, _mm_set1_epi32(0x00ffffff)), zero));
+    }
+    return ~_mm_movemask_ps(_mm_castsi128_ps(empty)) & 0xf;
+}
+#endif
+
+#ifdef IMG_NEON
+inline bool neonAny(uint32x4_t mask) { return vmaxvq_u32(mask) != 0; }
+
+inline uint32x4_t neonContent(const QRgb *pixels, bool cropBlack) {
+    const uint32x4_t v = vld1q_u32(pixels);
+    uint32x4_t content = vtstq_u32(v, vdupq_n_u32(0xff000000));
+    if (cropBlack) {
+        content = vandq_u32(content, vtstq_u32(v, vdupq_n_u32(0x00ffffff)));
+    }
+    return content;
+}
+#endif
+} // namespace
+
+QMutex ImgTools::derivedMutex;
+QCache<QString, QImage> ImgTools::derivedImages(DERIVEDCACHESIZE);
+
+ImageInfo ImgTools::imageInfo(const QByteArray &data) {
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    ImageInfo info;
+    info.format = reader.format();
+    if (info.format == "jpeg") {
+        info.format = "jpg";
+    }
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        return ImageInfo();
+    }
+    info.width = image.width();
+    info.height = image.height();
+    info.pixelFormat = image.format();
+    info.alpha = hasAlpha(image);
+    // Opaque pixels are all content
+    info.content = image.hasAlphaChannel() ? contentRect(argb32(image))
+                                           : image.rect();
+    return info;
+}
+
 QImage ImgTools::cropToFit(const QImage &image, bool cropBlack) {
-    int left = image.width();
-    int right = 0;
+    const QImage argb = argb32(image);
+    const QRect rect = contentRect(argb, cropBlack);
+    // Only crop if non-alpha, non-black pixels are found
+    if (rect.isValid()) {
+        return argb.copy(rect);
+    }
+    return image;
+}
+
+QRect ImgTools::contentRect(const QImage &image, bool cropBlack) {
+    const int width = image.width();
+    const int height = image.height();
+    auto line = [&image](int y) {
+        return (const QRgb *)image.constScanLine(y);
+    };
+    // Scan inward from every edge and stop at the first content, rows in
+    // the middle are only touched within the margins found so far
     int top = 0;
-    int bottom = image.height();
-
-    bool pixelsFound = false;
-
-    // Find lefmost edge
-    for (int y = 0; y < image.height(); ++y) {
-        QRgb *scanline = (QRgb *)image.scanLine(y);
-        for (int x = 0; x < image.width(); ++x) {
-            if (qAlpha(scanline[x]) > 0 &&
-                (cropBlack ? qRed(scanline[x]) > 0 || qGreen(scanline[x]) > 0 ||
-                                 qBlue(scanline[x]) > 0
-                           : true)) {
-                pixelsFound = true;
-                if (left > x) {
-                    left = x;
-                }
-                if (right < x) {
-                    right = x + 1;
-                }
-                if (top == 0) {
-                    top = y;
-                }
-                bottom = y + 1;
-            }
+    while (top < height && findContent(line(top), 0, width, cropBlack) < 0) {
+        ++top;
+    }
+    if (top == height) {
+        return QRect();
+    }
+    int bottom = height - 1;
+    while (findContent(line(bottom), 0, width, cropBlack) < 0) {
+        --bottom;
+    }
+    int left = width;
+    int right = -1;
+    for (int y = top; y <= bottom; ++y) {
+        const int first = findContent(line(y), 0, left, cropBlack);
+        if (first >= 0) {
+            left = first;
+        }
+        const int last = findLastContent(line(y), right + 1, width, cropBlack);
+        if (last >= 0) {
+            right = last;
         }
     }
-    // Only crop if non-alpha, non-black pixels are found
-    if (pixelsFound) {
-        QImage cropped = image.copy(left, top, right - left, bottom - top);
-        return cropped;
+    return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+bool ImgTools::hasAlpha(const QImage &image, int threshold) {
+    if (!image.hasAlphaChannel()) {
+        return false;
+    }
+    const QImage argb = argb32(image);
+    for (int y = 0; y < argb.height(); ++y) {
+        if (findAlphaBelow((const QRgb *)argb.constScanLine(y), argb.width(),
+                           threshold)) {
+            return true;
+        }
     }
+    return false;
+}
+
+QImage ImgTools::argb32(const QImage &image) {
+    if (image.format() == QImage::Format_ARGB32 ||
+        image.format() == QImage::Format_ARGB32_Premultiplied ||
+        image.format() == QImage::Format_RGB32) {
+        return image;
+    }
+    return image.convertToFormat(image.hasAlphaChannel()
+                                     ? QImage::Format_ARGB32_Premultiplied
+                                     : QImage::Format_RGB32);
+}
+
+QImage ImgTools::derived(const QString &key,
+                         const std::function<QImage()> &make) {
+    {
+        QMutexLocker locker(&derivedMutex);
+        if (QImage *image = derivedImages.object(key)) {
+            return *image;
+        }
+    }
+    // Created outside the lock, worst case two threads make the same image
+    QImage image = make();
+    QMutexLocker locker(&derivedMutex);
+    derivedImages.insert(key, new QImage(image),
+                         (int)(image.sizeInBytes() / 1024) + 1);
     return image;
 }
+
+int ImgTools::findContent(const QRgb *line, int begin, int end,
+                          bool cropBlack) {
+    int x = begin;
+#ifdef IMG_SSE2
+    for (; x + 4 <= end; x += 4) {
+        if (const int mask = sse2Content(line + x, cropBlack)) {
+            // Lowest set bit is the first content pixel
+            return x + (mask & 1 ? 0 : mask & 2 ? 1 : mask & 4 ? 2 : 3);
+        }
+    }
+#elif defined(IMG_NEON)
+    for (; x + 4 <= end; x += 4) {
+        if (neonAny(neonContent(line + x, cropBlack))) {
+            break;
+        }
+    }
+#endif
+    for (; x < end; ++x) {
+        if (isContent(line[x], cropBlack)) {
+            return x;
+        }
+    }
+    return -1;
+}
+
+int ImgTools::findLastContent(const QRgb *line, int begin, int end,
+                              bool cropBlack) {
+    int x = end;
+#ifdef IMG_SSE2
+    for (; x - 4 >= begin; x -= 4) {
+        if (const int mask = sse2Content(line + x - 4, cropBlack)) {
+            return x - 4 + (mask & 8 ? 3 : mask & 4 ? 2 : mask & 2 ? 1 : 0);
+        }
+    }
+#elif defined(IMG_NEON)
+    for (; x - 4 >= begin; x -= 4) {
+        if (neonAny(neonContent(line + x - 4, cropBlack))) {
+            break;
+        }
+    }
+#endif
+    while (--x >= begin) {
+        if (isContent(line[x], cropBlack)) {
+            return x;
+        }
+    }
+    return -1;
+}
+
+bool ImgTools::findAlphaBelow(const QRgb *line, int count, int threshold) {
+    int x = 0;
+#ifdef IMG_SSE2
+    const __m128i limit = _mm_set1_epi32(threshold);
+    for (; x + 4 <= count; x += 4) {
+        const __m128i alpha =
+            _mm_srli_epi32(_mm_loadu_si128((const __m128i *)(line + x)), 24);
+        if (_mm_movemask_epi8(_mm_cmplt_epi32(alpha, limit))) {
+            return true;
+        }
+    }
+#elif defined(IMG_NEON)
+    const uint32x4_t limit = vdupq_n_u32(threshold);
+    for (; x + 4 <= count; x += 4) {
+        const uint32x4_t alpha = vshrq_n_u32(vld1q_u32(line + x), 24);
+        if (neonAny(vcltq_u32(alpha, limit))) {
+            return true;
+        }
+    }
+#endif
+    for (; x < count; ++x) {
+        if (qAlpha(line[x]) < threshold) {
+            return true;
+        }
+    }
+    return false;
+}
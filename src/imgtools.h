@@ -26,12 +26,60 @@
 #ifndef IMGTOOLS_H
 #define IMGTOOLS_H
 
+#include <QCache>
 #include <QImage>
+#include <QMutex>
 #include <QObject>
 
+#include <functional>
+
+// What the cache records of an image resource, so it needn't be decoded to
+// tell. See ImgTools::imageInfo
+struct ImageInfo {
+    int width = -1;
+    int height = -1;
+    // File format, e.g. "png" or "jpg"
+    QByteArray format = QByteArray();
+    // Pixel format of the decoded image
+    QImage::Format pixelFormat = QImage::Format_Invalid;
+    // hasAlpha() with the default threshold
+    bool alpha = false;
+    // contentRect() without cropBlack, invalid if there is no content
+    QRect content = QRect();
+
+    bool isValid() const { return width > 0 && height > 0; }
+};
+
 class ImgTools : public QObject {
 public:
+    // Decodes data once to describe it, invalid if it isn't an image
+    static ImageInfo imageInfo(const QByteArray &data);
+    // Crops to the bounding box of the not transparent (and with cropBlack
+    // not black) pixels, the image is returned as is if there are none
     static QImage cropToFit(const QImage &image, bool cropBlack = false);
+    // That bounding box of an ARGB32 image, invalid if there is no content
+    static QRect contentRect(const QImage &image, bool cropBlack = false);
+    // True if any pixel has an alpha below threshold
+    static bool hasAlpha(const QImage &image, int threshold = 127);
+    // Images derived from static resources only (scaled masks, frames and
+    // overlays, rounded corner masks, ...) shared by all threads. make() is
+    // called on a miss, the key must cover every parameter it depends on.
+    // Least recently used images are dropped beyond DERIVEDCACHESIZE
+    static QImage derived(const QString &key,
+                          const std::function<QImage()> &make);
+
+private:
+    // Image as ARGB32, ARGB32 premultiplied or RGB32, converted if needed
+    static QImage argb32(const QImage &image);
+    // Index of the first (last) content pixel in [begin, end) or -1
+    static int findContent(const QRgb *line, int begin, int end,
+                           bool cropBlack);
+    static int findLastContent(const QRgb *line, int begin, int end,
+                               bool cropBlack);
+    static bool findAlphaBelow(const QRgb *line, int count, int threshold);
+
+    static QMutex derivedMutex;
+    static QCache<QString, QImage> derivedImages;
 };
 
 #endif // IMGTOOLS_H
@@ -25,6 +25,8 @@
 
 #include "layer.h"
 
+#include "imagewriter.h"
+
 #include <QMap>
 #include <math.h>
 
@@ -93,8 +95,6 @@ void Layer::setAxis(const QString &axis) {
     }
 }
 
-void Layer::setCanvas(const QImage &canvas) { this->canvas = canvas; }
-
 void Layer::setResource(const QString &resource) { this->resource = resource; }
 
 void Layer::setAlign(const QString &align) { this->align = align; }
@@ -147,46 +147,63 @@ void Layer::setOpacity(const int &opacity) {
     this->opacity = opacity;
 }
 
+void Layer::setKernel(const QString &kernel) {
+    if (kernel == "gaussian")
+        this->gaussian = true;
+    else if (kernel == "box")
+        this->gaussian = false;
+}
+
+void Layer::setAntialias(const bool &antialias) {
+    this->antialias = antialias;
+}
+
+void Layer::setFormat(const QString &format) {
+    this->format = format.toLower().toLatin1();
+    if (this->format == "jpeg")
+        this->format = "jpg";
+}
+
+void Layer::setCompression(const int &compression) {
+    this->compression = qBound(-1, compression, 9);
+}
+
+void Layer::setQuality(const int &quality) {
+    this->quality = qBound(-1, quality, 100);
+}
+
 // Add new layer
 void Layer::addLayer(const Layer &layer) { this->layers.append(layer); }
 
-QList<Layer> Layer::getLayers() { return layers; }
+void Layer::setLayers(const QList<Layer> &layers) { this->layers = layers; }
 
-void Layer::makeTransparent() { canvas.fill(Qt::transparent); }
+const QList<Layer> &Layer::getLayers() const { return layers; }
 
-void Layer::scale() {
+QImage Layer::scale(const QImage &canvas) const {
     if (mPixels > 0.0) {
         double currentMPixels = canvas.width() * canvas.height() / 1000000.0;
         double scaleFactor = sqrt(mPixels / currentMPixels);
-        canvas = canvas.scaledToWidth(canvas.width() * scaleFactor, transform);
-        return;
+        return canvas.scaledToWidth(canvas.width() * scaleFactor, transform);
     }
     if (width == -1 && height != -1) {
-        canvas = canvas.scaledToHeight(height, transform);
+        return canvas.scaledToHeight(height, transform);
     } else if (width != -1 && height == -1) {
-        canvas = canvas.scaledToWidth(width, transform);
+        return canvas.scaledToWidth(width, transform);
     } else if (width != -1 && height != -1) {
-        canvas = canvas.scaled(width, height, aspect, transform);
+        return canvas.scaled(width, height, aspect, transform);
     }
+    return canvas;
 }
 
-void Layer::premultiply() {
-    canvas = canvas.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-}
-
-void Layer::updateSize() {
-    width = canvas.width();
-    height = canvas.height();
-}
-
-bool Layer::hasLayers() {
+bool Layer::hasLayers() const {
     if (layers.isEmpty()) {
         return false;
     }
     return true;
 }
 
-bool Layer::save(QString filename) {
+bool Layer::save(QImage canvas, const QString &filename,
+                 const std::function<void(bool)> &written) const {
     // Check if canvas is largely transparent. If so, don't save it
     const QRgb *canvasBits = (QRgb *)canvas.constBits();
     quint64 noOfPixels = (quint64)canvas.width() * canvas.height();
@@ -201,15 +218,22 @@ bool Layer::save(QString filename) {
         return false;
     }
 
-    canvas = canvas.convertToFormat(QImage::Format_ARGB6666_Premultiplied);
+    if (format == "png") {
+        canvas = canvas.convertToFormat(QImage::Format_ARGB6666_Premultiplied);
+    } else if (format == "jpg") {
+        // No transparency in JPEG
+        canvas = canvas.convertToFormat(QImage::Format_RGB32);
+    } else {
+        canvas = canvas.convertToFormat(QImage::Format_ARGB32);
+    }
 
     if (canvas.isNull())
         return false;
 
-    if (canvas.save(filename)) {
-        return true;
-    }
-    return false;
+    // Written in the background, failures are reported by the writer
+    ImageWriter::write(canvas, filename, format, compression, quality,
+                       written);
+    return true;
 }
 
 void Layer::colorFromHex(QString color) {
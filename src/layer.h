@@ -45,16 +45,48 @@ constexpr int T_SATURATION = 15;
 constexpr int T_COLORIZE = 16;
 constexpr int T_ROTATE = 17;
 constexpr int T_SCANLINES = 18;
+// Fused per channel effects, only created when the artwork is compiled
+constexpr int T_LUT = 19;
+
+// Where the canvas of a layer comes from, resolved when the artwork is
+// compiled
+constexpr int R_NONE = 0;   // Transparent canvas
+constexpr int R_STATIC = 1; // Image of the resources folder
+constexpr int R_COVER = 2;  // Game images from here on, see Compositor
+constexpr int R_SCREENSHOT = 3;
+constexpr int R_WHEEL = 4;
+constexpr int R_MARQUEE = 5;
+constexpr int R_TEXTURE = 6;
+
+// Alignment of a layer within its parent
+constexpr int A_START = 0;
+constexpr int A_CENTER = 1;
+constexpr int A_END = 2;
 
 #include <QImage>
 #include <QPainter>
 
+#include <functional>
+
+// What compositing a layer for one game produces. The parsed Layer tree is
+// shared by all threads and never changes while rendering
+struct Canvas {
+    // Format_ARGB32_Premultiplied, as are the resources. All Fx classes take
+    // and return premultiplied pixels and never convert in between. Those
+    // working in place take the image by value, so a moved in image isn't
+    // copied
+    QImage image = QImage();
+    // Size the children are aligned with. Effects like the shadow grow the
+    // image beyond it
+    int width = -1;
+    int height = -1;
+};
+
 class Layer {
 public:
     Layer();
 
     int type = T_NONE;
-    QImage canvas = QImage();
     QString resType = "";
     QString resource = "";
     QString align = "";
@@ -74,6 +106,22 @@ public:
     int distance = -1;
     int softness = -1;
     int opacity = -1;
+    bool gaussian = false;
+    bool antialias = false;
+    int slot = R_NONE;
+    int hAlign = A_START;
+    int vAlign = A_START;
+    // Results of all (value, alpha) pairs for T_LUT, see FxKernels::applyLut
+    QImage lut = QImage();
+    // Hash of the xml, static resources and settings a T_OUTPUT depends
+    // on, and the game image slots it reads as 1 << slot. See
+    // Compositor::digestOutputs
+    QByteArray digest = QByteArray();
+    int inputs = 0;
+    // Encoder of T_OUTPUT, see ImageWriter::write
+    QByteArray format = "png";
+    int compression = -1;
+    int quality = -1;
     QPainter::CompositionMode mode = QPainter::CompositionMode_SourceOver;
     Qt::Axis axis = Qt::ZAxis;
     int saturation = 127;
@@ -85,7 +133,6 @@ public:
     void setAxis(const QString &axis);
     void setType(const int &type);
     void setResType(const QString &resType);
-    void setCanvas(const QImage &canvas);
     void setResource(const QString &resource);
     void setAlign(const QString &align);
     void setVAlign(const QString &valign);
@@ -105,16 +152,22 @@ public:
     void setDistance(const int &distance);
     void setSoftness(const int &softness);
     void setOpacity(const int &opacity);
+    void setKernel(const QString &kernel);
+    void setAntialias(const bool &antialias);
+    void setFormat(const QString &format);
+    void setCompression(const int &compression);
+    void setQuality(const int &quality);
 
     void addLayer(const Layer &layer);
-    QList<Layer> getLayers();
+    void setLayers(const QList<Layer> &layers);
+    const QList<Layer> &getLayers() const;
 
-    void makeTransparent();
-    void scale();
-    void premultiply();
-    void updateSize();
-    bool hasLayers();
-    bool save(QString filename);
+    QImage scale(const QImage &canvas) const;
+    bool hasLayers() const;
+    // Queues canvas to be written, false if there is nothing to write.
+    // written gets the outcome, see ImageWriter::write
+    bool save(QImage canvas, const QString &filename,
+              const std::function<void(bool)> &written = nullptr) const;
 
     void colorFromHex(QString color);
 
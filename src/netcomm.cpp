@@ -25,11 +25,33 @@
 
 #include "netcomm.h"
 
+#include <QDateTime>
 #include <QDebug>
-#include <QNetworkRequest>
+#include <QEventLoop>
+#include <QMutexLocker>
+#include <QRandomGenerator>
 #include <QUrl>
 
 constexpr int MAXSIZE = 100 * 1000 * 1000;
+// Retry backoff: BACKOFFBASE * 2^attempt ms with jitter, capped at BACKOFFMAX
+constexpr int BACKOFFBASE = 1000;
+constexpr int BACKOFFMAX = 30000;
+// Never honour a 'Retry-After' longer than this (ms)
+constexpr int RETRYAFTERMAX = 120000;
+// Circuit breaker: open after CBFAILURES consecutive transient failures
+// towards a host, pause that host for CBCOOLDOWN * 2^(trips - 1) ms and give
+// up on it entirely after CBMAXTRIPS trips without a single success
+constexpr int CBFAILURES = 5;
+constexpr int CBCOOLDOWN = 30000;
+constexpr int CBMAXTRIPS = 4;
+// Size of the cache of recent shared replies in KiB
+constexpr int SHAREDCACHESIZE = 32 * 1024;
+
+QMutex NetComm::hostMutex;
+QMap<QString, NetComm::HostState> NetComm::hostStates;
+QMutex NetComm::sharedMutex;
+QMap<QString, QList<NetComm *>> NetComm::inFlight;
+QCache<QString, NetComm::SharedReply> NetComm::recent(SHAREDCACHESIZE);
 
 NetComm::NetComm(QSharedPointer<NetManager> manager) : manager(manager) {
     requestTimer.setSingleShot(true);
@@ -37,6 +59,27 @@ NetComm::NetComm(QSharedPointer<NetManager> manager) : manager(manager) {
     connect(&requestTimer, &QTimer::timeout, this, &NetComm::requestTimeout);
 }
 
+NetComm::~NetComm() {
+    QMutexLocker locker(&sharedMutex);
+    if (leader) {
+        // Nobody will share a reply with the instances waiting on us, let
+        // them send their own request
+        for (auto *follower : inFlight.take(sharedKey)) {
+            QMetaObject::invokeMethod(
+                follower,
+                [follower]() {
+                    follower->dispatchRequest(follower->pendingRequest,
+                                              follower->pendingPostData);
+                },
+                Qt::QueuedConnection);
+        }
+    } else if (inFlight.contains(sharedKey)) {
+        inFlight[sharedKey].removeAll(this);
+    }
+}
+
+void NetComm::setShared(const bool enable) { sharing = enable; }
+
 void NetComm::request(QString query, QString postData,
                       QList<QPair<QString, QString>> headers) {
     QUrl url(query);
@@ -55,6 +98,119 @@ void NetComm::request(QString query, QString postData,
     }
     request.setHeader(QNetworkRequest::UserAgentHeader, ua);
 
+    host = url.host();
+    hostDown = false;
+    sharedKey.clear();
+    if (sharing && postData != "HEAD" && joinShared(request, postData)) {
+        return;
+    }
+    dispatchRequest(request, postData);
+}
+
+// Sends the request unless the circuit breaker has given up on the host, in
+// which case it fails right away. A paused host is waited out first
+void NetComm::dispatchRequest(const QNetworkRequest &request,
+                              const QString &postData) {
+    qint64 delay = getHostDelay(host);
+    if (delay < 0) {
+        // Circuit breaker has given up on this host. Fail right away instead
+        // of burning time and quota on a request that is doomed anyway
+        hostDown = true;
+        data.clear();
+        error = QNetworkReply::ServiceUnavailableError;
+        contentType.clear();
+        redirUrl.clear();
+        headerPairs.clear();
+        httpStatus = 0;
+        retryAfter = -1;
+        if (leader) {
+            shareReply();
+        }
+        QTimer::singleShot(0, this, &NetComm::dataReady);
+    } else if (delay > 0) {
+        // Host is paused by the circuit breaker or a 'Retry-After', wait it
+        // out before sending
+        QTimer::singleShot((int)delay, this, [this, request, postData]() {
+            sendRequest(request, postData);
+        });
+    } else {
+        sendRequest(request, postData);
+    }
+}
+
+bool NetComm::joinShared(const QNetworkRequest &request,
+                         const QString &postData) {
+    sharedKey = request.url().toString(QUrl::NormalizePathSegments) + "\n" +
+                postData;
+    QMutexLocker locker(&sharedMutex);
+    if (SharedReply *cached = recent.object(sharedKey)) {
+        applyReply(*cached);
+        QTimer::singleShot(0, this, &NetComm::dataReady);
+        return true;
+    }
+    if (inFlight.contains(sharedKey)) {
+        // Same request is on its way already, wait for its reply
+        pendingRequest = request;
+        pendingPostData = postData;
+        inFlight[sharedKey].append(this);
+        return true;
+    }
+    inFlight.insert(sharedKey, QList<NetComm *>());
+    leader = true;
+    return false;
+}
+
+void NetComm::shareReply() {
+    leader = false;
+    SharedReply shared;
+    shared.data = data;
+    shared.contentType = contentType;
+    shared.redirUrl = redirUrl;
+    shared.headerPairs = headerPairs;
+    shared.httpStatus = httpStatus;
+    bool ok = error == QNetworkReply::NoError && httpStatus == 200 &&
+              !data.isEmpty();
+
+    QMutexLocker locker(&sharedMutex);
+    if (ok) {
+        recent.insert(sharedKey, new SharedReply(shared),
+                      data.size() / 1024 + 1);
+    }
+    for (auto *follower : inFlight.take(sharedKey)) {
+        // Failures are not shared, the follower may well have more luck
+        if (ok) {
+            QMetaObject::invokeMethod(
+                follower,
+                [follower, shared]() {
+                    follower->applyReply(shared);
+                    emit follower->dataReady();
+                },
+                Qt::QueuedConnection);
+        } else {
+            QMetaObject::invokeMethod(
+                follower,
+                [follower]() {
+                    follower->dispatchRequest(follower->pendingRequest,
+                                              follower->pendingPostData);
+                },
+                Qt::QueuedConnection);
+        }
+    }
+}
+
+void NetComm::applyReply(const SharedReply &shared) {
+    data = shared.data;
+    error = QNetworkReply::NoError;
+    contentType = shared.contentType;
+    redirUrl = shared.redirUrl;
+    headerPairs = shared.headerPairs;
+    httpStatus = shared.httpStatus;
+    retryAfter = -1;
+    timedOut = false;
+}
+
+void NetComm::sendRequest(QNetworkRequest request, QString postData) {
+    timedOut = false;
     if (postData.isNull()) {
         // GET iff postData is null, as "" is in use for POST w/o postData
         // No body -> no Content-Type
@@ -80,10 +236,154 @@ void NetComm::replyReady() {
     contentType = reply->rawHeader("Content-Type");
     redirUrl = reply->rawHeader("Location");
     headerPairs = reply->rawHeaderPairs();
+    httpStatus =
+        reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    retryAfter = -1;
+    QByteArray retryAfterValue = reply->rawHeader("Retry-After").trimmed();
+    if (!retryAfterValue.isEmpty()) {
+        // Either delta-seconds or an HTTP-date. Clamped before narrowing, so
+        // a bogus value can't overflow into a negative or random pause
+        bool ok = false;
+        qint64 secs = retryAfterValue.toLongLong(&ok);
+        if (ok) {
+            if (secs >= 0) {
+                retryAfter =
+                    (int)(qMin<qint64>(secs, RETRYAFTERMAX / 1000) * 1000);
+            }
+        } else {
+            QDateTime when = QDateTime::fromString(QString(retryAfterValue),
+                                                   Qt::RFC2822Date);
+            if (when.isValid()) {
+                retryAfter = (int)qBound<qint64>(
+                    0, QDateTime::currentDateTimeUtc().msecsTo(when.toUTC()),
+                    RETRYAFTERMAX);
+            }
+        }
+    }
     reply->deleteLater();
+    updateHostState();
+    if (leader) {
+        shareReply();
+    }
     emit dataReady();
 }
 
+int NetComm::getHttpStatus() { return httpStatus; }
+
+bool NetComm::isRetryable() {
+    if (hostDown) {
+        return false;
+    }
+    if (httpStatus == 408 || httpStatus == 429 || httpStatus == 500 ||
+        httpStatus == 502 || httpStatus == 503 || httpStatus == 504) {
+        return true;
+    }
+    switch (error) {
+    case QNetworkReply::NoError:
+        // Transport went fine but caller still wants to retry, ie. truncated
+        // or empty data
+        return true;
+    case QNetworkReply::OperationCanceledError:
+        // Also used when aborting due to MAXSIZE, only retry on timeouts
+        return timedOut;
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::ServiceUnavailableError:
+    case QNetworkReply::InternalServerError:
+    case QNetworkReply::UnknownServerError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int NetComm::getRetryDelay(const int attempt) {
+    if (!sharedKey.isEmpty()) {
+        // The caller rejected this reply, don't hand it out again
+        QMutexLocker locker(&sharedMutex);
+        recent.remove(sharedKey);
+    }
+    if (retryAfter >= 0) {
+        return retryAfter;
+    }
+    int delay = qMin(BACKOFFMAX, BACKOFFBASE << qMin(attempt, 5));
+    // Equal jitter, so workers that failed together don't retry together
+    return delay / 2 + QRandomGenerator::global()->bounded(delay / 2 + 1);
+}
+
+void NetComm::waitForRetry(const int attempt) {
+    int delay = getRetryDelay(attempt);
+    if (delay > 0) {
+        QEventLoop loop;
+        QTimer::singleShot(delay, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+}
+
+bool NetComm::isHostDown(const QString &host) {
+    QMutexLocker locker(&hostMutex);
+    return hostStates.contains(host) && hostStates[host].trips > CBMAXTRIPS;
+}
+
+qint64 NetComm::getHostDelay(const QString &host) {
+    QMutexLocker locker(&hostMutex);
+    if (!hostStates.contains(host)) {
+        return 0;
+    }
+    const HostState &state = hostStates[host];
+    if (state.trips > CBMAXTRIPS) {
+        return -1;
+    }
+    return qMax<qint64>(0,
+                        state.openUntil - QDateTime::currentMSecsSinceEpoch());
+}
+
+void NetComm::updateHostState() {
+    if (host.isEmpty()) {
+        return;
+    }
+    QMutexLocker locker(&hostMutex);
+    HostState &state = hostStates[host];
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (httpStatus == 429) {
+        // Throttled, but the service is alive. Hold back every worker sharing
+        // this host for as long as we are told to
+        int pause = retryAfter >= 0 ? retryAfter : BACKOFFBASE * 5;
+        state.openUntil = qMax(state.openUntil, now + pause);
+        return;
+    }
+    bool transient = (error != QNetworkReply::NoError || httpStatus >= 500) &&
+                     isRetryable();
+    if (!transient) {
+        state.failures = 0;
+        state.trips = 0;
+        return;
+    }
+    if (retryAfter >= 0) {
+        state.openUntil = qMax(state.openUntil, now + retryAfter);
+    }
+    state.failures++;
+    if (state.failures >= CBFAILURES) {
+        state.failures = 0;
+        state.trips++;
+        if (state.trips > CBMAXTRIPS) {
+            printf("\033[1;31mGiving up on '%s', the service has not been "
+                   "responding for a while...\033[0m\n",
+                   host.toStdString().c_str());
+            return;
+        }
+        int cooldown = CBCOOLDOWN << (state.trips - 1);
+        state.openUntil = qMax(state.openUntil, now + cooldown);
+        printf("\033[1;33m'%s' seems to be down, pausing all requests to it "
+               "for %d seconds...\033[0m\n",
+               host.toStdString().c_str(), cooldown / 1000);
+    }
+}
+
 QByteArray NetComm::getData() { return data; }
 
 QString NetComm::getHeaderValue(const QString headerKey) {
@@ -168,5 +468,6 @@ void NetComm::dataDownloaded(qint64 bytesReceived, qint64) {
 void NetComm::requestTimeout() {
     printf("\033[1;33mRequest timed out, server might be busy / "
            "overloaded...\033[0m\n");
+    timedOut = true;
     reply->abort();
 }
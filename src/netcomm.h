@@ -28,7 +28,11 @@
 
 #include "netmanager.h"
 
+#include <QCache>
+#include <QMap>
+#include <QMutex>
 #include <QNetworkReply>
+#include <QNetworkRequest>
 #include <QTimer>
 
 class NetComm : public QObject {
@@ -36,6 +40,7 @@ class NetComm : public QObject {
 
 public:
     NetComm(QSharedPointer<NetManager> manager);
+    ~NetComm();
     void request(QString query, QString postData = QString(),
                  QList<QPair<QString, QString>> headers =
                      QList<QPair<QString, QString>>());
@@ -44,6 +49,15 @@ public:
     QByteArray getContentType();
     QByteArray getRedirUrl();
     QString getHeaderValue(const QString headerKey);
+    int getHttpStatus();
+    bool isRetryable();
+    int getRetryDelay(const int attempt);
+    void waitForRetry(const int attempt);
+    static bool isHostDown(const QString &host);
+    // Identical GET/POST requests of all shared NetComm instances are sent
+    // only once, the others wait for and receive that reply. Successful
+    // replies are kept for a short while
+    void setShared(const bool enable);
 
 private slots:
     void replyReady();
@@ -54,6 +68,37 @@ signals:
     void dataReady();
 
 private:
+    struct HostState {
+        int failures = 0;
+        int trips = 0;
+        qint64 openUntil = 0;
+    };
+
+    struct SharedReply {
+        QByteArray data;
+        QByteArray contentType;
+        QByteArray redirUrl;
+        QList<QNetworkReply::RawHeaderPair> headerPairs;
+        int httpStatus = 0;
+    };
+
+    void dispatchRequest(const QNetworkRequest &request,
+                         const QString &postData);
+    void sendRequest(QNetworkRequest request, QString postData);
+    bool joinShared(const QNetworkRequest &request, const QString &postData);
+    void shareReply();
+    void applyReply(const SharedReply &shared);
+    void updateHostState();
+    qint64 getHostDelay(const QString &host);
+
+    static QMutex hostMutex;
+    static QMap<QString, HostState> hostStates;
+    static QMutex sharedMutex;
+    // Requests being sent and the instances waiting for them, by request key
+    static QMap<QString, QList<NetComm *>> inFlight;
+    // Recent successful replies by request key, cost is in KiB
+    static QCache<QString, SharedReply> recent;
+
     QSharedPointer<NetManager> manager;
     QTimer requestTimer;
     QByteArray data;
@@ -62,6 +107,16 @@ private:
     QByteArray redirUrl;
     QNetworkReply *reply;
     QList<QNetworkReply::RawHeaderPair> headerPairs;
+    QString host;
+    int httpStatus = 0;
+    int retryAfter = -1;
+    bool timedOut = false;
+    bool hostDown = false;
+    bool sharing = false;
+    bool leader = false;
+    QString sharedKey;
+    QNetworkRequest pendingRequest;
+    QString pendingPostData;
 };
 
 #endif // NETCOMM_H
@@ -31,16 +31,37 @@ NetManager::NetManager() {}
 
 QNetworkReply *NetManager::getRequest(const QNetworkRequest &request) {
     QMutexLocker locker(&requestMutex);
-    return get(request);
+    return get(applyOverride(request));
 }
 
 QNetworkReply *NetManager::headRequest(const QNetworkRequest &request) {
     QMutexLocker locker(&requestMutex);
-    return head(request);
+    return head(applyOverride(request));
 }
 
 QNetworkReply *NetManager::postRequest(const QNetworkRequest &request,
                                        const QByteArray &data) {
     QMutexLocker locker(&requestMutex);
-    return post(request, data);
+    return post(applyOverride(request), data);
+}
+
+void NetManager::setBaseUrlOverride(const QUrl &url) {
+    QMutexLocker locker(&requestMutex);
+    baseUrlOverride = url;
+}
+
+QNetworkRequest NetManager::applyOverride(const QNetworkRequest &request) {
+    if (baseUrlOverride.isEmpty()) {
+        return request;
+    }
+    // Send everything to the override (ie. a local stand-in service), keep
+    // path and query. The original host is passed on for routing
+    QNetworkRequest redirected(request);
+    QUrl url = request.url();
+    redirected.setRawHeader("X-Original-Host", url.host().toUtf8());
+    url.setScheme(baseUrlOverride.scheme());
+    url.setHost(baseUrlOverride.host());
+    url.setPort(baseUrlOverride.port());
+    redirected.setUrl(url);
+    return redirected;
 }
@@ -29,6 +29,7 @@
 #include <QMutex>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QUrl>
 
 class NetManager : public QNetworkAccessManager {
     Q_OBJECT
@@ -39,8 +40,12 @@ public:
     QNetworkReply *headRequest(const QNetworkRequest &request);
     QNetworkReply *postRequest(const QNetworkRequest &request,
                                const QByteArray &data);
+    void setBaseUrlOverride(const QUrl &url);
 
 private:
+    QNetworkRequest applyOverride(const QNetworkRequest &request);
+
     QMutex requestMutex;
+    QUrl baseUrlOverride;
 };
 #endif // NETMANAGER_H
@@ -45,6 +45,14 @@ QFileInfo Queue::takeEntry() {
     return info;
 }
 
+QList<QFileInfo> Queue::takeEntries(const int max) {
+    // Like takeEntry() this expects the mutex locked by hasEntry()
+    QList<QFileInfo> infos = mid(0, max);
+    erase(begin(), begin() + infos.size());
+    queueMutex.unlock();
+    return infos;
+}
+
 void Queue::clearAll() {
     queueMutex.lock();
     clear();
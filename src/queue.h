@@ -35,6 +35,7 @@ public:
     Queue();
     bool hasEntry();
     QFileInfo takeEntry();
+    QList<QFileInfo> takeEntries(const int max);
     void clearAll();
     void filterFiles(const QString &patterns, const bool &include = false);
     void removeFiles(const QList<QString> &files);
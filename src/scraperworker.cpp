@@ -29,6 +29,7 @@
 #include "cache.h"
 #include "compositor.h"
 #include "esgamelist.h"
+#include "fileexport.h"
 #include "gamebase.h"
 #include "gameentry.h"
 #include "igdb.h"
@@ -110,9 +111,18 @@ void ScraperWorker::run() {
         exit(1);
     }
 
-    while (queue->hasEntry()) {
-        // takeEntry() also unlocks the mutex that was locked in hasEntry()
-        QFileInfo info = queue->takeEntry();
+    const int batchSize = scraper->getBatchSize();
+    QList<QFileInfo> batch;
+    while (!batch.isEmpty() || queue->hasEntry()) {
+        if (batch.isEmpty()) {
+            // takeEntries() also unlocks the mutex that was locked in
+            // hasEntry()
+            batch = queue->takeEntries(batchSize);
+            if (batchSize > 1) {
+                prefetchBatch(batch);
+            }
+        }
+        QFileInfo info = batch.takeFirst();
         // Reset platform in case we have manipulated it (such as changing
         // 'amiga' to 'cd32')
         config.platform = platformOrig;
@@ -521,8 +531,9 @@ void ScraperWorker::run() {
         if (config.manuals) {
             output.append(
                 "Manual:         " +
-                QString((game.manualData.isEmpty() ? "\033[1;31mNO"
-                                                   : "\033[1;32mYES")) +
+                QString((game.manualData.isEmpty() && game.manualFile.isEmpty()
+                             ? "\033[1;31mNO"
+                             : "\033[1;32mYES")) +
                 "\033[0m (" + game.manualSrc + ")\n");
         }
         output.append("\nDescription: (" + game.descriptionSrc +
@@ -547,7 +558,32 @@ void ScraperWorker::run() {
     emit allDone();
 }
 
+void ScraperWorker::prefetchBatch(const QList<QFileInfo> &infos) {
+    QList<QFileInfo> lookups;
+    for (const auto &info : infos) {
+        if (config.onlyMissing) {
+            QString cacheId = cache->getQuickId(info);
+            if (cacheId.isEmpty()) {
+                cacheId = NameTools::getCacheId(info);
+                cache->addQuickId(info, cacheId);
+            }
+            if (cache->hasEntries(cacheId)) {
+                // Will be skipped anyway
+                continue;
+            }
+        }
+        lookups.append(info);
+    }
+    scraper->prefetchBatch(lookups);
+}
+
 bool ScraperWorker::limitReached(QString &output) {
+    if (scraper->serviceDown()) {
+        output.append("\033[1;31m'" + config.scraper +
+                      "' is not responding, forcing thread " + threadId +
+                      " to stop...\033[0m\n");
+        return true;
+    }
     if (scraper->reqRemaining != -1) { // -1 means there is no limit
         if (scraper->reqRemaining > 0) {
             output.append("\n\033[1;33m'" + config.scraper +
@@ -883,7 +919,6 @@ void ScraperWorker::copyMedia(const QString &mediaType,
 
     const QString fmt = isVideoType ? game.videoFormat : "pdf";
     const QString fn = isVideoType ? game.videoFile : game.manualFile;
-    const QByteArray data = isVideoType ? game.videoData : game.manualData;
     const bool mediaTypeEnabled = isVideoType ? config.videos : config.manuals;
     const bool skipExisting =
         isVideoType ? config.skipExistingVideos : config.skipExistingManuals;
@@ -909,26 +944,22 @@ void ScraperWorker::copyMedia(const QString &mediaType,
         absMediaFn = mediaTypeFolder % "/" % absMediaFn;
 
         if (!(skipExisting && QFile::exists(absMediaFn))) {
-            QFile::remove(absMediaFn);
-            if (config.symlink && isVideoType) {
-                if (QFile::link(fn, absMediaFn)) {
-                    zapInGamelist = false;
-                } else {
-                    qWarning() << "Symlink failed, media entry will be not in "
-                                  "game list: "
-                               << absMediaFn << "->" << fn;
-                }
+            // The cache replaces its files instead of writing to them, a
+            // hardlink keeps the exported file intact
+            const bool symlink = config.symlink && isVideoType;
+            if (FileExport::place(fn, absMediaFn,
+                                  symlink ? FileExport::SYMLINK
+                                          : FileExport::HARDLINK) !=
+                FileExport::FAILED) {
+                zapInGamelist = false;
+            } else if (symlink) {
+                qWarning() << "Symlink failed, media entry will be not in "
+                              "game list: "
+                           << absMediaFn << "->" << fn;
             } else {
-                QFile fh(absMediaFn);
-                if (fh.open(QIODevice::WriteOnly)) {
-                    fh.write(data);
-                    fh.close();
-                    zapInGamelist = false;
-                } else {
-                    qWarning()
-                        << "Copy failed, media entry will be not in game list: "
-                        << fn << "to" << absMediaFn;
-                }
+                qWarning()
+                    << "Copy failed, media entry will be not in game list: "
+                    << fn << "to" << absMediaFn;
             }
         }
     }
@@ -77,6 +77,7 @@ private:
     int getReleaseYear(const QString releaseDateString);
 
     bool limitReached(QString &output);
+    void prefetchBatch(const QList<QFileInfo> &infos);
     void copyMedia(const QString &mediaType, const QString &completeBaseName,
                    const QString &subPath, GameEntry &game);
     bool matchTitles(const QString &thiz, const QString &that);
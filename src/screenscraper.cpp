@@ -35,6 +35,7 @@
 #include <QJsonDocument>
 #include <QProcess>
 #include <QRegularExpression>
+#include <QUrl>
 
 constexpr int RETRIESMAX = 4;
 constexpr int MINARTSIZE = 256;
@@ -42,12 +43,9 @@ constexpr int MINARTSIZE = 256;
 ScreenScraper::ScreenScraper(Settings *config,
                              QSharedPointer<NetManager> manager)
     : AbstractScraper(config, manager, MatchType::MATCH_ONE) {
-    connect(&limitTimer, &QTimer::timeout, &limiter, &QEventLoop::quit);
-    limitTimer.setInterval(
-        1200); // 1.2 second request limit set a bit above 1.0 as requested by
-               // the good folks at ScreenScraper. Don't change!
-    limitTimer.setSingleShot(false);
-    limitTimer.start();
+    requestInterval = 1200; // 1.2 second request limit set a bit above 1.0
+                            // as requested by the good folks at
+                            // ScreenScraper. Don't change!
 
     baseUrl = "http://www.screenscraper.fr";
 
@@ -90,7 +88,11 @@ void ScreenScraper::getSearchResults(QList<GameEntry> &gameEntries,
         "&output=json&" + searchName;
 
     for (int retries = 0; retries < RETRIESMAX; ++retries) {
-        limiter.exec();
+        if (retries > 0) {
+            // Back off exponentially, or as told by 'Retry-After'
+            netComm->waitForRetry(retries);
+        }
+        waitForRequestSlot();
         netComm->request(gameUrl);
         q.exec();
         data = netComm->getData();
@@ -100,6 +102,12 @@ void ScreenScraper::getSearchResults(QList<GameEntry> &gameEntries,
         // Do error checks on headerData. It's more stable than checking the
         // potentially faulty JSON
         if (headerData.isEmpty()) {
+            if (!netComm->isRetryable()) {
+                if (NetComm::isHostDown(QUrl(gameUrl).host())) {
+                    reqRemaining = 0;
+                }
+                return;
+            }
             printf("\033[1;33mRetrying request...\033[0m\n\n");
             continue;
         } else if (headerData.contains("non trouvée")) {
@@ -352,48 +360,58 @@ void ScreenScraper::getTags(GameEntry &game) {
     game.tags.chop(2);
 }
 
-QByteArray ScreenScraper::downloadImageWithRetry(const QString &url) {
-    QByteArray d;
-    if (!url.isEmpty()) {
-        for (int retries = 0; retries < RETRIESMAX; ++retries) {
-            limiter.exec();
-            d = downloadMedia(url);
-            if (d.size() >= MINARTSIZE) {
-                break;
-            }
-        }
+void ScreenScraper::downloadImageWithRetry(const QString &url,
+                                           QByteArray &target,
+                                           const int retries, const int delay) {
+    if (url.isEmpty()) {
+        return;
     }
-    return d;
+    requestAsync(
+        url,
+        [this, url, &target, retries](NetComm &comm) {
+            target = mediaFromReply(comm, true);
+            if (target.size() < MINARTSIZE && retries + 1 < RETRIESMAX &&
+                comm.isRetryable()) {
+                // Back off exponentially, or as told by 'Retry-After'
+                downloadImageWithRetry(url, target, retries + 1,
+                                       comm.getRetryDelay(retries + 1));
+            }
+        },
+        delay);
 }
 
 void ScreenScraper::downloadBinary(const QString &url, const QString &type,
-                                   GameEntry &game) {
-    bool isVideoType = type == "video";
-    for (int retries = 0; retries < RETRIESMAX; ++retries) {
-        limiter.exec();
-        netComm->request(url);
-        q.exec();
-        if (netComm->getError(config->verbosity) == QNetworkReply::NoError) {
-            QByteArray contentType = netComm->getContentType();
-            // Make sure received data is actually a video or  PDF file
-            if (isVideoType) {
-                QByteArray d = netComm->getData();
-                if (contentType.contains("video/") && d.size() > 4096) {
-                    game.videoData = d;
-                    game.videoFormat = contentType.mid(
-                        contentType.indexOf("/") + 1,
-                        contentType.length() - contentType.indexOf("/") + 1);
-                    game.videoData = netComm->getData();
-                    break;
-                }
-            } else {
-                if (contentType.contains("application/pdf")) {
-                    game.manualData = netComm->getData();
-                    break;
+                                   GameEntry &game, const int retries,
+                                   const int delay) {
+    requestAsync(
+        url,
+        [this, url, type, &game, retries](NetComm &comm) {
+            if (comm.getError(config->verbosity) == QNetworkReply::NoError) {
+                QByteArray contentType = comm.getContentType();
+                // Make sure received data is actually a video or  PDF file
+                if (type == "video") {
+                    QByteArray d = comm.getData();
+                    if (contentType.contains("video/") && d.size() > 4096) {
+                        game.videoData = d;
+                        game.videoFormat =
+                            contentType.mid(contentType.indexOf("/") + 1,
+                                            contentType.length() -
+                                                contentType.indexOf("/") + 1);
+                        return;
+                    }
+                } else {
+                    if (contentType.contains("application/pdf")) {
+                        game.manualData = comm.getData();
+                        return;
+                    }
                 }
             }
-        }
-    }
+            if (retries + 1 < RETRIESMAX && comm.isRetryable()) {
+                downloadBinary(url, type, game, retries + 1,
+                               comm.getRetryDelay(retries + 1));
+            }
+        },
+        delay);
 }
 
 void ScreenScraper::getCover(GameEntry &game) {
@@ -408,32 +426,32 @@ void ScreenScraper::getCover(GameEntry &game) {
         url = getJsonText(jsonObj["medias"].toArray(), REGION,
                           QList<QString>({"box-2D"}));
     }
-    game.coverData = downloadImageWithRetry(url);
+    downloadImageWithRetry(url, game.coverData);
 }
 
 void ScreenScraper::getScreenshot(GameEntry &game) {
     QString url = getJsonText(jsonObj["medias"].toArray(), REGION,
                               QList<QString>({"ss", "sstitle"}));
-    game.screenshotData = downloadImageWithRetry(url);
+    downloadImageWithRetry(url, game.screenshotData);
 }
 
 void ScreenScraper::getWheel(GameEntry &game) {
     QString url = getJsonText(jsonObj["medias"].toArray(), REGION,
                               QList<QString>({"wheel(-hd)?"}));
-    game.wheelData = downloadImageWithRetry(url);
+    downloadImageWithRetry(url, game.wheelData);
 }
 
 void ScreenScraper::getMarquee(GameEntry &game) {
     QString url = getJsonText(jsonObj["medias"].toArray(), REGION,
                               QList<QString>({"screenmarquee"}));
-    game.marqueeData = downloadImageWithRetry(url);
+    downloadImageWithRetry(url, game.marqueeData);
 }
 
 void ScreenScraper::getTexture(GameEntry &game) {
     QString url =
         getJsonText(jsonObj["medias"].toArray(), REGION,
                     QList<QString>({"support-2[Dd]", "support-texture"}));
-    game.textureData = downloadImageWithRetry(url);
+    downloadImageWithRetry(url, game.textureData);
 }
 
 void ScreenScraper::getVideo(GameEntry &game) {
@@ -28,9 +28,7 @@
 
 #include "abstractscraper.h"
 
-#include <QEventLoop>
 #include <QJsonObject>
-#include <QTimer>
 
 constexpr int REGION = 0;
 constexpr int LANGUE = 1;
@@ -46,8 +44,6 @@ protected:
     QString applyQuerySearchName(QString query) override;
 
 private:
-    QTimer limitTimer;
-    QEventLoop limiter;
     QList<QString> getSearchNames(const QFileInfo &info,
                                   QString &debug) override;
     void getSearchResults(QList<GameEntry> &gameEntries, QString searchName,
@@ -72,9 +68,11 @@ private:
 
     QString getJsonText(QJsonArray array, int attr,
                         QList<QString> types = QList<QString>());
-    QByteArray downloadImageWithRetry(const QString &url);
+    void downloadImageWithRetry(const QString &url, QByteArray &target,
+                                const int retries = 0, const int delay = 0);
     void downloadBinary(const QString &url, const QString &type,
-                        GameEntry &game);
+                        GameEntry &game, const int retries = 0,
+                        const int delay = 0);
     QString getUrlOrTextPropertyValue(const QJsonObject &jsonVal,
                                       const QString &key,
                                       const QString &matchValue);
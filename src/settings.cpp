@@ -27,6 +27,7 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QStringBuilder>
+#include <QUrl>
 #include <filesystem>
 
 static inline bool isArcadePlatform(const QString &platform) {
@@ -158,6 +159,18 @@ void RuntimeCfg::applyConfigIni(CfgType type, QSettings *settings,
                 config->addExtensions = parseExtensions(v);
                 continue;
             }
+            if (k == "artworkPassthrough") {
+                QStringList allowed({"off", "copy", "link"});
+                if (allowed.contains(v)) {
+                    config->artworkPassthrough = v;
+                } else {
+                    printf("\033[1;33mValue '%s' of %s is not one of %s and "
+                           "is ignored!\n\033[0m",
+                           v.toStdString().c_str(), k.toUtf8().constData(),
+                           allowed.join(", ").toUtf8().constData());
+                }
+                continue;
+            }
             if (k == "artworkXml") {
                 config->artworkConfig = toAbsolutePath(false, v);
                 continue;
@@ -301,6 +314,17 @@ void RuntimeCfg::applyConfigIni(CfgType type, QSettings *settings,
                 config->regionPriosStr = v;
                 continue;
             }
+            if (k == "scraperBaseUrl") {
+                QUrl url(v);
+                if (url.isValid() && !url.host().isEmpty()) {
+                    config->scraperBaseUrl = v;
+                } else {
+                    printf("\033[1;33mValue '%s' is not a valid URL and is "
+                           "ignored! Consult the documentation.\n\033[0m",
+                           v.toStdString().c_str());
+                }
+                continue;
+            }
             if (k == "scummIni") {
                 if (!validateFileParameter(k, v)) {
                     exit(1);
@@ -487,6 +511,16 @@ void RuntimeCfg::applyConfigIni(CfgType type, QSettings *settings,
                        k.toUtf8().constData());
                 exit(1);
             }
+            if (k == "artworkPixelBudget") {
+                if (0 <= v && v <= 1000) {
+                    config->artworkPixelBudget = v;
+                } else {
+                    printf("\033[1;33mValue of %d is out of range and is "
+                           "ignored! Consult the documentation.\n\033[0m",
+                           v);
+                }
+                continue;
+            }
             if (k == "jpgQuality") {
                 if (0 < v && v <= 100) {
                     config->jpgQuality = v;
@@ -539,6 +573,16 @@ void RuntimeCfg::applyConfigIni(CfgType type, QSettings *settings,
                 }
                 continue;
             }
+            if (k == "videoConvertJobs") {
+                if (0 < v && v <= 16) {
+                    config->videoConvertJobs = v;
+                } else {
+                    printf("\033[1;33mValue of %d is out of range and is "
+                           "ignored! Consult the documentation.\n\033[0m",
+                           v);
+                }
+                continue;
+            }
             if (k == "videoSizeLimit") {
                 config->videoSizeLimit = v * 1000 * 1000;
                 continue;
@@ -51,6 +51,7 @@ struct Settings {
     QString platform = "";
     bool arcadePlatform;
     QString scraper = "";
+    QString scraperBaseUrl = "";
     QString userCreds = "";
     QString igdbToken = "";
     QString inputFolder = "";
@@ -72,6 +73,7 @@ struct Settings {
     int doneThreads = 0;
     int threads = 4;
     bool threadsSet = false;
+    int inFlight = 4; // Concurrent async requests per thread
     int minMatch = 65;
     bool minMatchSet = false;
     int maxLength = 2500;
@@ -99,6 +101,12 @@ struct Settings {
     bool ignoreYearInFilename = false;
     QString artworkConfig = "";
     QByteArray artworkXml = "";
+    // How artwork identical to its cached resource is exported: "off"
+    // re-encodes it, "copy" or "link" place the cache file, see FileExport
+    QString artworkPassthrough = "copy";
+    // Megapixels a game image may have while compositing, larger ones are
+    // decoded downscaled and rendered one layer at a time. 0 is unlimited
+    int artworkPixelBudget = 0;
     QString excludePattern = "";
     QString includePattern = "";
     QString includeFrom = "";
@@ -123,6 +131,7 @@ struct Settings {
     int videoSizeLimit = 100 * 1000 * 1000;
     QString videoConvertCommand = "";
     QString videoConvertExtension = "";
+    int videoConvertJobs = 2;
     bool symlink = false;
     bool skipExistingVideos = false;
     bool cacheCovers = true;
@@ -194,6 +203,8 @@ private:
         // clang-format off
         {"addExtensions",           QPair<QString, int>("str",  CfgType::MAIN | CfgType::PLATFORM                                        )},
         {"addFolders",              QPair<QString, int>("bool",                                     CfgType::FRONTEND                    )},
+        {"artworkPassthrough",      QPair<QString, int>("str",  CfgType::MAIN | CfgType::PLATFORM | CfgType::FRONTEND                    )},
+        {"artworkPixelBudget",      QPair<QString, int>("int",  CfgType::MAIN | CfgType::PLATFORM | CfgType::FRONTEND                    )},
         {"artworkXml",              QPair<QString, int>("str",  CfgType::MAIN | CfgType::PLATFORM | CfgType::FRONTEND                    )},
         {"brackets",                QPair<QString, int>("bool", CfgType::MAIN | CfgType::PLATFORM | CfgType::FRONTEND                    )},
         {"cacheCovers",             QPair<QString, int>("bool", CfgType::MAIN | CfgType::PLATFORM |                     CfgType::SCRAPER )},
@@ -244,6 +255,7 @@ private:
         {"region",                  QPair<QString, int>("str",  CfgType::MAIN | CfgType::PLATFORM                                        )},
         {"regionPrios",             QPair<QString, int>("str",  CfgType::MAIN | CfgType::PLATFORM                                        )},
         {"relativePaths",           QPair<QString, int>("bool", CfgType::MAIN | CfgType::PLATFORM                                        )},
+        {"scraperBaseUrl",          QPair<QString, int>("str",  CfgType::MAIN |                                         CfgType::SCRAPER )},
         {"scummIni",                QPair<QString, int>("str",  CfgType::MAIN                                                            )},
         {"skipped",                 QPair<QString, int>("bool", CfgType::MAIN | CfgType::PLATFORM | CfgType::FRONTEND                    )},
         {"spaceCheck",              QPair<QString, int>("bool", CfgType::MAIN                                                            )},
@@ -260,6 +272,7 @@ private:
         {"verbosity",               QPair<QString, int>("int",  CfgType::MAIN | CfgType::PLATFORM | CfgType::FRONTEND                    )},
         {"videoConvertCommand",     QPair<QString, int>("str",  CfgType::MAIN |                                         CfgType::SCRAPER )},
         {"videoConvertExtension",   QPair<QString, int>("str",  CfgType::MAIN |                                         CfgType::SCRAPER )},
+        {"videoConvertJobs",        QPair<QString, int>("int",  CfgType::MAIN |                                         CfgType::SCRAPER )},
         {"videoPreferNormalized",   QPair<QString, int>("bool",                                                         CfgType::SCRAPER )},
         {"videos",                  QPair<QString, int>("bool", CfgType::MAIN | CfgType::PLATFORM | CfgType::FRONTEND | CfgType::SCRAPER )},
         {"videoSizeLimit",          QPair<QString, int>("int",  CfgType::MAIN | CfgType::PLATFORM |                     CfgType::SCRAPER )}
@@ -27,9 +27,11 @@
 
 #include "attractmode.h"
 #include "cli.h"
+#include "compositor.h"
 #include "config.h"
 #include "emulationstation.h"
 #include "esde.h"
+#include "imagewriter.h"
 #include "pegasus.h"
 #include "settings.h"
 #include "strtools.h"
@@ -47,6 +49,7 @@
 #include <QStringBuilder>
 #include <QThread>
 #include <QTimer>
+#include <QUrl>
 #include <iostream>
 
 Skyscraper::Skyscraper(const QString &currentDir) {
@@ -74,6 +77,9 @@ void Skyscraper::run() {
         } else if (config.cacheOptions == "validate") {
             Cache::validateAllPlatform(config, this);
             exit(0);
+        } else if (config.cacheOptions == "backfill") {
+            Cache::backfillAllPlatform(config, this);
+            exit(0);
         } else {
             exit(1);
         }
@@ -204,6 +210,14 @@ void Skyscraper::run() {
         state = SINGLE;
         exit(0);
     }
+    if (config.cacheOptions == "backfill") {
+        if (cache->backfill()) {
+            state = NO_INTR; // Ignore ctrl+c
+            cache->write();
+            state = SINGLE;
+        }
+        exit(0);
+    }
     if (config.cacheOptions.contains("merge:")) {
         QFileInfo mergeCacheInfo(config.cacheOptions.replace("merge:", ""));
 
@@ -402,6 +416,11 @@ void Skyscraper::run() {
     timer.start();
     currentFile = 1;
 
+    if (config.artworkPixelBudget > 0) {
+        // Images waiting to be written count against the budget as well
+        ImageWriter::setMaxQueued(1);
+    }
+
     QList<QThread *> threadList;
     for (int curThread = 1; curThread <= config.threads; ++curThread) {
         QThread *thread = new QThread;
@@ -702,6 +721,27 @@ void Skyscraper::checkThreads() {
     if (doneThreads != config.threads)
         return;
 
+    // Artwork is written in the background, the game list may only point to
+    // complete files
+    const QStringList unwritten = ImageWriter::waitForDone();
+    if (!unwritten.isEmpty()) {
+        printf("\033[1;31m%d artwork file(s) could not be written, check file "
+               "permissions and free space.\033[0m\n",
+               (int)unwritten.size());
+        // A failed write keeps an earlier version, only files that don't
+        // exist at all are left out of the game list
+        for (auto &entry : gameEntries) {
+            for (QString *file :
+                 {&entry.coverFile, &entry.screenshotFile, &entry.wheelFile,
+                  &entry.marqueeFile, &entry.textureFile}) {
+                if (unwritten.contains(*file) && !QFileInfo::exists(*file)) {
+                    file->clear();
+                }
+            }
+        }
+    }
+    Compositor::writeManifest();
+
     if (!config.pretend && config.scraper == "cache") {
         printf("\033[1;34m---- Game list generation run completed! YAY! "
                "----\033[0m\n");
@@ -1094,7 +1134,10 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser) {
         // reduce key to relative filepath
         resFile =
             resFile.remove(0, resFile.indexOf(resFolder) + resFolder.length());
-        config.resources[resFile] = QImage(resFolder % resFile);
+        // Converted once, the compositor works on premultiplied pixels only
+        config.resources[resFile] =
+            QImage(resFolder % resFile)
+                .convertToFormat(QImage::Format_ARGB32_Premultiplied);
     }
 }
 
@@ -1130,6 +1173,12 @@ void Skyscraper::prepareScraping() {
     setRegionPrios();
     setLangPrios();
 
+    if (!config.scraperBaseUrl.isEmpty()) {
+        printf("\033[1;33mSending all requests to '%s'\033[0m\n\n",
+               config.scraperBaseUrl.toStdString().c_str());
+        manager->setBaseUrlOverride(QUrl(config.scraperBaseUrl));
+    }
+
     NetComm netComm(manager);
     QEventLoop q; // Event loop for use when waiting for data from NetComm.
     connect(&netComm, &NetComm::dataReady, &q, &QEventLoop::quit);
@@ -1290,6 +1339,9 @@ void Skyscraper::prepareIgdb(NetComm &netComm, QEventLoop &q) {
 void Skyscraper::prepareScreenscraper(NetComm &netComm, QEventLoop &q) {
     const int threadsFailsafe = 1; // Don't change! This limit was set by
                                    // request from ScreenScraper
+    // Each thread may have several media downloads in flight. Keep the total
+    // number of connections within what the account allows
+    config.inFlight = 1;
     if (config.user.isEmpty() || config.password.isEmpty()) {
         if (config.threads > 1) {
             config.threads = threadsFailsafe;
@@ -1352,6 +1404,7 @@ void Skyscraper::prepareScreenscraper(NetComm &netComm, QEventLoop &q) {
                            "account.\n\n",
                            config.threads);
                 }
+                config.inFlight = qMax(1, allowedThreads / config.threads);
             }
         }
     }
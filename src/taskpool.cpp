@@ -0,0 +1,81 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include "taskpool.h"
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+namespace {
+class Task : public QRunnable {
+public:
+    Task(const std::function<void()> &task, QSemaphore &done)
+        : task(task), done(done) {
+        setAutoDelete(false);
+    }
+    void run() override {
+        task();
+        done.release();
+    }
+
+private:
+    std::function<void()> task;
+    QSemaphore &done;
+};
+} // namespace
+
+void TaskPool::run(const QList<std::function<void()>> &tasks) {
+    if (tasks.size() < 2) {
+        for (const auto &task : tasks) {
+            task();
+        }
+        return;
+    }
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore done;
+    QList<Task *> queued;
+    for (int a = 1; a < tasks.size(); ++a) {
+        Task *task = new Task(tasks.at(a), done);
+        pool->start(task);
+        queued.append(task);
+    }
+    tasks.first()();
+    for (auto *task : queued) {
+        if (pool->tryTake(task)) {
+            task->run();
+        }
+    }
+    done.acquire(queued.size());
+    qDeleteAll(queued);
+}
+
+void TaskPool::runRanges(const int count, const int minChunk,
+                         const std::function<void(int, int)> &range) {
+    const int chunks = qBound(
+        1, count / qMax(1, minChunk),
+        qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+    QList<std::function<void()>> tasks;
+    for (int a = 0; a < chunks; ++a) {
+        const int begin = (int)((qint64)count * a / chunks);
+        const int end = (int)((qint64)count * (a + 1) / chunks);
+        tasks.append([&range, begin, end]() { range(begin, end); });
+    }
+    run(tasks);
+}
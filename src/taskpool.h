@@ -0,0 +1,40 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <QList>
+
+#include <functional>
+
+namespace TaskPool {
+    // Runs independent tasks on the global QThreadPool and waits for them.
+    // The calling thread does its share: it runs the first task and then any
+    // task no pool thread has picked up yet. Nested calls therefore never
+    // wait on tasks that are still queued, and a busy pool degrades to
+    // serial execution
+    void run(const QList<std::function<void()>> &tasks);
+    // Splits [0, count) into ranges of at least minChunk and runs them as
+    // tasks
+    void runRanges(const int count, const int minChunk,
+                   const std::function<void(int, int)> &range);
+} // namespace TaskPool
+
+#endif // TASKPOOL_H
@@ -200,53 +200,35 @@ void TheGamesDb::getTags(GameEntry &game) {
 
 void TheGamesDb::getCover(GameEntry &game) {
     QString req = gfxUrl + "/boxart/front/" + game.id + "-1";
-    game.coverData = downloadMedia(req + ".jpg");
-    if (game.coverData.isEmpty()) {
-        game.coverData = downloadMedia(req + ".png");
-    }
+    downloadMediaAsync({req + ".jpg", req + ".png"},
+                       [&game](QByteArray d) { game.coverData = d; });
 }
 
 void TheGamesDb::getScreenshot(GameEntry &game) {
-    QString req;
-    QStringList exts = {".jpg", ".png"};
+    QStringList reqs;
     // some platforms use screenshot/ rather than screenshots/
-    QStringList pl = {"s/", "/"};
-    int i = 0;
-    do {
-        int k = 0;
-        do {
-            req = gfxUrl + "/screenshot" + pl[k] + game.id + "-1" + exts[i];
-            netComm->request(req);
-            q.exec();
-            k++;
-        } while (k < 2 && netComm->getError() != QNetworkReply::NoError);
-        i++;
-    } while (i < 2 && netComm->getError() != QNetworkReply::NoError);
-
-    QImage image;
-    if (netComm->getError() == QNetworkReply::NoError &&
-        image.loadFromData(netComm->getData())) {
-        game.screenshotData = netComm->getData();
-        qDebug() << "tgdb: got screenshot from " << req;
+    for (const auto &ext : {".jpg", ".png"}) {
+        for (const auto &pl : {"s/", "/"}) {
+            reqs.append(gfxUrl + "/screenshot" + pl + game.id + "-1" + ext);
+        }
     }
+    downloadMediaAsync(reqs, [&game](QByteArray d) {
+        game.screenshotData = d;
+        qDebug() << "tgdb: got screenshot:" << !d.isEmpty();
+    });
 }
 
 void TheGamesDb::getWheel(GameEntry &game) {
-    QString req = gfxUrl + "/clearlogo/" + game.id + "-1";
-    game.wheelData = downloadMedia(req + ".png");
-    if (game.wheelData.isEmpty()) {
-        // legacy, try without "-1"
-        req.chop(2);
-        game.wheelData = downloadMedia(req + ".png");
-    }
+    QString req = gfxUrl + "/clearlogo/" + game.id;
+    // legacy, try without "-1"
+    downloadMediaAsync({req + "-1.png", req + ".png"},
+                       [&game](QByteArray d) { game.wheelData = d; });
 }
 
 void TheGamesDb::getMarquee(GameEntry &game) {
     QString req = gfxUrl + "/graphical/" + game.id + "-g";
-    game.marqueeData = downloadMedia(req + ".jpg");
-    if (game.marqueeData.isEmpty()) {
-        game.marqueeData = downloadMedia(req + ".png");
-    }
+    downloadMediaAsync({req + ".jpg", req + ".png"},
+                       [&game](QByteArray d) { game.marqueeData = d; });
 }
 
 void TheGamesDb::loadMaps() {
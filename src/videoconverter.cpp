@@ -0,0 +1,347 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include "videoconverter.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+namespace {
+const QString ELEM = "conversion";
+const QString ATTR_FILE = "file";
+const QString ATTR_KEY = "key";
+const QString ATTR_MODIFIED = "modified";
+const QString ATTR_RESULT = "result";
+const QString ATTR_SIZE = "size";
+
+class ConvertTask : public QRunnable {
+public:
+    ConvertTask(std::function<void()> job) : job(job) {}
+    void run() override { job(); }
+
+private:
+    std::function<void()> job;
+};
+
+bool replaceWith(const QString &source, const QString &file) {
+    if (QFile::exists(file) && !QFile::remove(file)) {
+        return false;
+    }
+    return QFile::copy(source, file);
+}
+} // namespace
+
+VideoConverter::VideoConverter(const QString &cacheFolder)
+    : cacheDir(QDir(cacheFolder).absolutePath()) {
+    pool.setMaxThreadCount(1);
+}
+
+VideoConverter::~VideoConverter() { waitForDone(); }
+
+VideoConverter::Status VideoConverter::convert(const QByteArray &data,
+                                               QString &cacheFile,
+                                               const Settings &config,
+                                               QString &output, Done done) {
+    if (!config.videoConvertCommand.contains("%i")) {
+        output.append(
+            "'videoConvertCommand' is missing the required %i tag.\n");
+        return FAILED;
+    }
+    if (!config.videoConvertCommand.contains("%o")) {
+        output.append(
+            "'videoConvertCommand' is missing the required %o tag.\n");
+        return FAILED;
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(data);
+    hash.addData(QString("\n" + config.videoConvertCommand + "\n" +
+                         config.videoConvertExtension)
+                     .toUtf8());
+    const QByteArray key = hash.result().toHex();
+    const QString file =
+        convertedFile(cacheFile, config.videoConvertExtension);
+
+    QMutexLocker locker(&mutex);
+    load();
+    if (outcomes.contains(key)) {
+        const Outcome outcome = outcomes.value(key);
+        locker.unlock();
+        if (outcome.ok && reuse(outcome, file)) {
+            cacheFile = file;
+            return REUSED;
+        }
+        if (!outcome.ok && !config.refresh) {
+            output.append("Failed in an earlier run, use '--refresh' to "
+                          "try again. ");
+            return FAILED;
+        }
+        locker.relock();
+    }
+    if (jobs.contains(key)) {
+        jobs[key].targets.append(Target{cacheFile, done});
+        return QUEUED;
+    }
+    locker.unlock();
+
+    // The input is written without holding the lock
+    QFile f(cacheFile);
+    if (!f.open(QIODevice::WriteOnly) || f.write(data) != data.size()) {
+        f.remove();
+        output.append("Error writing file: '" + f.fileName() +
+                      "' to cache. Please check permissions. ");
+        return FAILED;
+    }
+    f.close();
+
+    locker.relock();
+    if (jobs.contains(key)) {
+        // The same video was queued meanwhile
+        f.remove();
+        jobs[key].targets.append(Target{cacheFile, done});
+        return QUEUED;
+    }
+    Job &job = jobs[key];
+    job.command = config.videoConvertCommand;
+    job.extension = config.videoConvertExtension;
+    job.verbosity = config.verbosity;
+    job.targets.append(Target{cacheFile, done});
+    pool.setMaxThreadCount(config.videoConvertJobs);
+    pool.start(new ConvertTask([this, key]() { run(key); }));
+    return QUEUED;
+}
+
+int VideoConverter::pendingJobs() {
+    QMutexLocker locker(&mutex);
+    int pending = 0;
+    for (const auto &job : jobs) {
+        pending += job.targets.size();
+    }
+    return pending;
+}
+
+int VideoConverter::waitForDone() {
+    pool.waitForDone();
+    QMutexLocker locker(&mutex);
+    if (changed) {
+        save();
+    }
+    return failed.fetchAndStoreRelaxed(0);
+}
+
+void VideoConverter::run(const QByteArray &key) {
+    Job job;
+    {
+        QMutexLocker locker(&mutex);
+        job = jobs.value(key);
+    }
+    const QString input = job.targets.first().cacheFile;
+    const QString file = convertedFile(input, job.extension);
+    QString output;
+    const bool ok = transcode(job, input, output);
+
+    QList<Target> targets;
+    {
+        QMutexLocker locker(&mutex);
+        // Targets added while converting are part of this job as well
+        targets = jobs.take(key).targets;
+        record(key, ok, file);
+    }
+    const QString name = QFileInfo(file).fileName();
+    if (ok) {
+        if (job.verbosity >= 1) {
+            printf("Video conversion of '%s': \033[1;32mSuccess!\033[0m\n%s",
+                   name.toStdString().c_str(), output.toStdString().c_str());
+        }
+    } else {
+        failed.fetchAndAddRelaxed(1);
+        printf("Video conversion of '%s': \033[1;31mFailed!\033[0m (set "
+               "higher '--verbosity N' level for more info)\n%s",
+               name.toStdString().c_str(), output.toStdString().c_str());
+    }
+
+    for (int a = 0; a < targets.size(); ++a) {
+        const QString target =
+            convertedFile(targets.at(a).cacheFile, job.extension);
+        targets.at(a).done(ok && (target == file || replaceWith(file, target)),
+                           target);
+    }
+}
+
+bool VideoConverter::transcode(const Job &job, const QString &input,
+                               QString &output) {
+    const QString file = convertedFile(input, job.extension);
+    const QFileInfo fileInfo(file);
+    const QString tmpFile =
+        fileInfo.absolutePath() + "/tmpfile_" + fileInfo.fileName();
+    QString command = job.command;
+    command.replace("%i", input);
+    command.replace("%o", tmpFile);
+    if (QFile::exists(tmpFile)) {
+        if (!QFile::remove(tmpFile)) {
+            output.append("'" + tmpFile +
+                          "' already exists and can't be removed.\n");
+            QFile::remove(input);
+            return false;
+        }
+    }
+    if (job.verbosity >= 2) {
+        output.append("%i: '" + input + "'\n");
+        output.append("%o: '" + tmpFile + "'\n");
+    }
+    if (job.verbosity >= 3) {
+        output.append("Running command: '" + command + "'\n");
+    }
+    QProcess convertProcess;
+    if (command.contains(" ")) {
+        convertProcess.start(command.split(' ').first(),
+                             QStringList({command.split(' ').mid(1)}));
+    } else {
+        convertProcess.start(command, QStringList({}));
+    }
+    // Wait 10 minutes max for conversion to complete
+    bool ok = convertProcess.waitForFinished(1000 * 60 * 10) &&
+              convertProcess.exitStatus() == QProcess::NormalExit &&
+              QFile::exists(tmpFile);
+    if (job.verbosity >= 3) {
+        output.append(convertProcess.readAllStandardOutput() + "\n");
+        output.append(convertProcess.readAllStandardError() + "\n");
+    }
+    if (!QFile::remove(input) && ok) {
+        output.append("Original '" + input + "' file couldn't be removed.\n");
+        ok = false;
+    }
+    if (ok && QFile::exists(file) && !QFile::remove(file)) {
+        output.append("'" + file + "' already exists and can't be removed.\n");
+        ok = false;
+    }
+    if (ok && !QFile::rename(tmpFile, file)) {
+        output.append("Couldn't rename file '" + tmpFile + "' to '" + file +
+                      "', please check permissions!\n");
+        ok = false;
+    }
+    if (!ok) {
+        QFile::remove(tmpFile);
+    }
+    return ok;
+}
+
+// An earlier result is only trusted as long as its file is unchanged
+bool VideoConverter::reuse(const Outcome &outcome, const QString &file) {
+    const QString source = cacheDir.absoluteFilePath(outcome.file);
+    const QFileInfo info(source);
+    if (!info.isFile() || info.size() != outcome.size ||
+        info.lastModified().toMSecsSinceEpoch() != outcome.modified) {
+        return false;
+    }
+    return source == file || replaceWith(source, file);
+}
+
+void VideoConverter::record(const QByteArray &key, bool ok,
+                            const QString &file) {
+    Outcome outcome;
+    outcome.ok = ok;
+    if (ok) {
+        const QFileInfo info(file);
+        outcome.file = cacheDir.relativeFilePath(file);
+        outcome.size = info.size();
+        outcome.modified = info.lastModified().toMSecsSinceEpoch();
+        // Results of other inputs converted to this file are overwritten now
+        QMutableMapIterator<QByteArray, Outcome> it(outcomes);
+        while (it.hasNext()) {
+            if (it.next().value().file == outcome.file) {
+                it.remove();
+            }
+        }
+    }
+    outcomes[key] = outcome;
+    changed = true;
+}
+
+void VideoConverter::load() {
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+    QFile outcomesFile(outcomesFilePath());
+    if (!outcomesFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QXmlStreamReader xml(&outcomesFile);
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement ||
+            xml.name() != ELEM) {
+            continue;
+        }
+        QXmlStreamAttributes attribs = xml.attributes();
+        if (!attribs.hasAttribute(ATTR_KEY) ||
+            !attribs.hasAttribute(ATTR_RESULT)) {
+            continue;
+        }
+        Outcome outcome;
+        outcome.ok = attribs.value(ATTR_RESULT) == QString("ok");
+        outcome.file = attribs.value(ATTR_FILE).toString();
+        outcome.size = attribs.value(ATTR_SIZE).toLongLong();
+        outcome.modified = attribs.value(ATTR_MODIFIED).toLongLong();
+        outcomes[attribs.value(ATTR_KEY).toString().toLatin1()] = outcome;
+    }
+}
+
+void VideoConverter::save() {
+    QSaveFile outcomesFile(outcomesFilePath());
+    if (!outcomesFile.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QXmlStreamWriter xml(&outcomesFile);
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+    xml.writeStartElement("conversions");
+    for (auto it = outcomes.constBegin(); it != outcomes.constEnd(); ++it) {
+        xml.writeStartElement(ELEM);
+        xml.writeAttribute(ATTR_KEY, QString::fromLatin1(it.key()));
+        xml.writeAttribute(ATTR_RESULT, it.value().ok ? "ok" : "failed");
+        if (it.value().ok) {
+            xml.writeAttribute(ATTR_FILE, it.value().file);
+            xml.writeAttribute(ATTR_SIZE, QString::number(it.value().size));
+            xml.writeAttribute(ATTR_MODIFIED,
+                               QString::number(it.value().modified));
+        }
+        xml.writeEndElement();
+    }
+    xml.writeEndElement();
+    xml.writeEndDocument();
+    if (outcomesFile.commit()) {
+        changed = false;
+    }
+}
+
+QString VideoConverter::convertedFile(const QString &cacheFile,
+                                      const QString &extension) {
+    const QFileInfo info(cacheFile);
+    if (extension.isEmpty()) {
+        return cacheFile;
+    }
+    return info.absolutePath() + "/" + info.completeBaseName() + "." +
+           extension;
+}
@@ -0,0 +1,100 @@
+/*
+ *  This file is part of skyscraper.
+ *  Copyright 2025 Gemba @ GitHub
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef VIDEOCONVERTER_H
+#define VIDEOCONVERTER_H
+
+#include "settings.h"
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QDir>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+
+#include <functional>
+
+// Runs 'videoConvertCommand' on a pool of its own, so the scraping threads
+// don't wait for the transcodes. Jobs are keyed by a hash of the input video
+// and the command, an input already being converted is converted only once
+// and the outcome of each conversion is kept in the cache folder for later
+// runs
+class VideoConverter {
+public:
+    enum Status { QUEUED, REUSED, FAILED };
+    // Called from a pool thread with the outcome and the converted file
+    typedef std::function<void(bool ok, const QString &file)> Done;
+
+    VideoConverter(const QString &cacheFolder);
+    ~VideoConverter();
+
+    // Converts data to cacheFile. REUSED sets cacheFile to the result of an
+    // earlier conversion right away, QUEUED calls done once the job finished
+    Status convert(const QByteArray &data, QString &cacheFile,
+                   const Settings &config, QString &output, Done done);
+    int pendingJobs();
+    // Waits for all jobs and saves their outcome, returns how many failed
+    int waitForDone();
+
+private:
+    struct Target {
+        QString cacheFile;
+        Done done;
+    };
+    struct Job {
+        QString command;
+        QString extension;
+        int verbosity = 0;
+        QList<Target> targets;
+    };
+    struct Outcome {
+        bool ok = false;
+        QString file;
+        qint64 size = 0;
+        qint64 modified = 0;
+    };
+
+    void run(const QByteArray &key);
+    bool transcode(const Job &job, const QString &input, QString &output);
+    bool reuse(const Outcome &outcome, const QString &file);
+    void record(const QByteArray &key, bool ok, const QString &file);
+    void load();
+    void save();
+
+    static QString convertedFile(const QString &cacheFile,
+                                 const QString &extension);
+
+    QDir cacheDir;
+    QThreadPool pool;
+    QMutex mutex;
+    QMap<QByteArray, Job> jobs;
+    QMap<QByteArray, Outcome> outcomes;
+    bool loaded = false;
+    bool changed = false;
+    QAtomicInt failed;
+
+    inline const QString outcomesFilePath() {
+        return cacheDir.path() + "/videoconvert.xml";
+    }
+};
+
+#endif // VIDEOCONVERTER_H
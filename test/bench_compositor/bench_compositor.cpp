@@ -0,0 +1,434 @@
+// Benchmark of the artwork pipeline.
+//
+// Generates synthetic covers, screenshots and wheels at three sizes and times
+// every Fx*::applyEffect(), ImgTools::cropToFit() and Layer::scale() on them.
+// Then composites games with Compositor::saveAll() for artwork.xml and each
+// shipped artwork.xml.example*, including the encoding of the files. Reports
+// MPix/s per effect and ms per game. The images come from a fixed seed and
+// the kernel code path and the thread count can be pinned, so results of
+// different builds or machines can be compared. Runs headless, the Qt
+// platform defaults to 'offscreen'.
+//
+//   ./bench_compositor -n 20 -g 50
+//   ./bench_compositor --isa scalar --threads 1 --filter blur
+//   ./bench_compositor --effects-only --size L
+
+#include "compositor.h"
+#include "fxbalance.h"
+#include "fxblur.h"
+#include "fxbrightness.h"
+#include "fxcolorize.h"
+#include "fxcontrast.h"
+#include "fxframe.h"
+#include "fxgamebox.h"
+#include "fxhue.h"
+#include "fxkernels.h"
+#include "fxmask.h"
+#include "fxopacity.h"
+#include "fxrotate.h"
+#include "fxrounded.h"
+#include "fxsaturation.h"
+#include "fxscanlines.h"
+#include "fxshadow.h"
+#include "fxstroke.h"
+#include "gameentry.h"
+#include "imagewriter.h"
+#include "imgtools.h"
+#include "layer.h"
+#include "settings.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QThreadPool>
+
+#include <functional>
+
+// Keeps the compiler from dropping the measured calls
+static volatile int sink = 0;
+
+struct Operation {
+    QString name;
+    std::function<QImage(const QImage &)> run;
+};
+
+static QImage noise(int width, int height, quint32 seed) {
+    QRandomGenerator rnd(seed);
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = (QRgb *)image.scanLine(y);
+        for (int x = 0; x < width; ++x) {
+            line[x] = 0xff000000 | (rnd.generate() & 0x00ffffff);
+        }
+    }
+    return image;
+}
+
+// Opaque cover with a transparent margin, as after scaling with aspect ratio
+static QImage cover(int width, int height) {
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.drawImage(width / 16, height / 44,
+                      noise(width - width / 8, height - height / 22, 4711));
+    return image;
+}
+
+// Opaque screenshot with black borders
+static QImage screenshot(int width, int height) {
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::black);
+    QPainter painter(&image);
+    painter.drawImage(width / 10, height / 30,
+                      noise(width - width / 5, height - height / 15, 4712));
+    return image;
+}
+
+// Logo with lots of transparency around it and soft edges
+static QImage wheel(int width, int height) {
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QBrush(noise(width, height, 4713)));
+    painter.drawEllipse(width * 3 / 20, height / 5, width * 7 / 10,
+                        height * 3 / 5);
+    return image;
+}
+
+static QByteArray encode(const QImage &image) {
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "png");
+    return data;
+}
+
+static Layer effect(int type) {
+    Layer layer;
+    layer.setType(type);
+    return layer;
+}
+
+static void add(QList<Operation> &ops, const QString &name,
+                std::function<QImage(const QImage &)> run) {
+    ops.append(Operation{name, run});
+}
+
+static QList<Operation> operations(Settings *config) {
+    QList<Operation> ops;
+    add(ops, "copy", [](const QImage &image) { return image.copy(); });
+    add(ops, "cropToFit",
+        [](const QImage &image) { return ImgTools::cropToFit(image); });
+    add(ops, "cropToFit black",
+        [](const QImage &image) { return ImgTools::cropToFit(image, true); });
+    add(ops, "scale", [](const QImage &image) {
+        Layer layer;
+        layer.setWidth(image.width() / 2);
+        layer.setHeight(image.height() / 2);
+        return layer.scale(image);
+    });
+    add(ops, "scale fast", [](const QImage &image) {
+        Layer layer;
+        layer.setWidth(image.width() / 2);
+        layer.setTransform("fast");
+        return layer.scale(image);
+    });
+
+    Layer balance = effect(T_BALANCE);
+    balance.setRed(20);
+    balance.setGreen(-10);
+    balance.setBlue(5);
+    add(ops, "balance", [=](const QImage &image) {
+        return FxBalance().applyEffect(image, balance);
+    });
+    Layer blur = effect(T_BLUR);
+    blur.setSoftness(20);
+    add(ops, "blur",
+        [=](const QImage &image) { return FxBlur().applyEffect(image, blur); });
+    Layer gaussian = blur;
+    gaussian.setKernel("gaussian");
+    add(ops, "blur gaussian", [=](const QImage &image) {
+        return FxBlur().applyEffect(image, gaussian);
+    });
+    Layer brightness = effect(T_BRIGHTNESS);
+    brightness.setDelta(30);
+    add(ops, "brightness", [=](const QImage &image) {
+        return FxBrightness().applyEffect(image, brightness);
+    });
+    Layer colorize = effect(T_COLORIZE);
+    colorize.setValue(200);
+    colorize.setDelta(100);
+    add(ops, "colorize", [=](const QImage &image) {
+        return FxColorize().applyEffect(image, colorize);
+    });
+    Layer contrast = effect(T_CONTRAST);
+    contrast.setDelta(30);
+    add(ops, "contrast", [=](const QImage &image) {
+        return FxContrast().applyEffect(image, contrast);
+    });
+    Layer frame = effect(T_FRAME);
+    frame.setResource("frameexample.png");
+    add(ops, "frame", [=](const QImage &image) {
+        return FxFrame().applyEffect(image, frame, config);
+    });
+    Layer gamebox = effect(T_GAMEBOX);
+    add(ops, "gamebox", [=](const QImage &image) {
+        return FxGamebox().applyEffect(image, gamebox, image, config);
+    });
+    Layer hue = effect(T_HUE);
+    hue.setDelta(120);
+    add(ops, "hue",
+        [=](const QImage &image) { return FxHue().applyEffect(image, hue); });
+    Layer mask = effect(T_MASK);
+    mask.setResource("maskexample.png");
+    add(ops, "mask", [=](const QImage &image) {
+        return FxMask().applyEffect(image, mask, config);
+    });
+    Layer opacity = effect(T_OPACITY);
+    opacity.setOpacity(60);
+    add(ops, "opacity", [=](const QImage &image) {
+        return FxOpacity().applyEffect(image, opacity);
+    });
+    Layer rotate = effect(T_ROTATE);
+    rotate.setDelta(15);
+    add(ops, "rotate", [=](const QImage &image) {
+        return FxRotate().applyEffect(image, rotate);
+    });
+    Layer rotateY = rotate;
+    rotateY.setAxis("y");
+    add(ops, "rotate y", [=](const QImage &image) {
+        return FxRotate().applyEffect(image, rotateY);
+    });
+    Layer rounded = effect(T_ROUNDED);
+    rounded.setWidth(25);
+    add(ops, "rounded", [=](const QImage &image) {
+        return FxRounded().applyEffect(image, rounded);
+    });
+    Layer saturation = effect(T_SATURATION);
+    saturation.setDelta(50);
+    add(ops, "saturation", [=](const QImage &image) {
+        return FxSaturation().applyEffect(image, saturation);
+    });
+    Layer scanlines = effect(T_SCANLINES);
+    scanlines.setMode("overlay");
+    add(ops, "scanlines", [=](const QImage &image) {
+        return FxScanlines().applyEffect(image, scanlines, config);
+    });
+    Layer shadow = effect(T_SHADOW);
+    shadow.setDistance(8);
+    shadow.setSoftness(10);
+    shadow.setOpacity(50);
+    add(ops, "shadow", [=](const QImage &image) {
+        return FxShadow().applyEffect(image, shadow);
+    });
+    Layer stroke = effect(T_STROKE);
+    stroke.setWidth(5);
+    add(ops, "stroke", [=](const QImage &image) {
+        return FxStroke().applyEffect(image, stroke);
+    });
+    Layer strokeAa = stroke;
+    strokeAa.setAntialias(true);
+    add(ops, "stroke antialias", [=](const QImage &image) {
+        return FxStroke().applyEffect(image, strokeAa);
+    });
+    return ops;
+}
+
+static double usPerCall(int runs, const std::function<void()> &call) {
+    QElapsedTimer timer;
+    timer.start();
+    for (int a = 0; a < runs; ++a) {
+        call();
+    }
+    return timer.nsecsElapsed() / 1000.0 / runs;
+}
+
+static const char *isaName(FxKernels::Isa isa) {
+    switch (isa) {
+    case FxKernels::ISA_SSE2:
+        return "sse2";
+    case FxKernels::ISA_AVX2:
+        return "avx2";
+    case FxKernels::ISA_NEON:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        {{"n", "runs"}, "Runs per effect measurement.", "N", "20"},
+        {{"g", "games"}, "Games composited per artwork file.", "N", "20"},
+        {{"t", "threads"}, "Threads of the global pool, 0 = all cores.", "N",
+         "0"},
+        {"isa", "Kernel code path: scalar, sse2, avx2 or neon.", "ISA"},
+        {"serial", "Don't split kernels into row ranges."},
+        {"size", "Only this image size: S, M or L.", "SIZE"},
+        {"filter", "Only operations containing TEXT.", "TEXT"},
+        {"effects-only", "Skip the Compositor::saveAll() runs."},
+        {"artwork-only", "Skip the single effect runs."},
+    });
+    parser.process(app);
+    const int runs = qMax(1, parser.value("runs").toInt());
+    const int games = qMax(1, parser.value("games").toInt());
+
+    if (parser.value("threads").toInt() > 0) {
+        QThreadPool::globalInstance()->setMaxThreadCount(
+            parser.value("threads").toInt());
+    }
+    if (parser.isSet("isa")) {
+        const QMap<QString, FxKernels::Isa> isas = {
+            {"scalar", FxKernels::ISA_SCALAR},
+            {"sse2", FxKernels::ISA_SSE2},
+            {"avx2", FxKernels::ISA_AVX2},
+            {"neon", FxKernels::ISA_NEON}};
+        const QString isa = parser.value("isa").toLower();
+        if (!isas.contains(isa) || !FxKernels::isSupported(isas.value(isa))) {
+            printf("Code path '%s' is not available in this build or on this "
+                   "CPU\n",
+                   isa.toUtf8().constData());
+            return 1;
+        }
+        FxKernels::setIsa(isas.value(isa));
+    }
+    FxKernels::setParallel(!parser.isSet("serial"));
+
+    // Run from the source root so artwork files and resources are found
+    QDir::setCurrent(SRCROOT);
+    Settings config;
+    QDirIterator resDirIt("resources", QDir::Files | QDir::NoDotAndDotDot,
+                          QDirIterator::Subdirectories);
+    while (resDirIt.hasNext()) {
+        const QString resFile = resDirIt.next();
+        config.resources[resFile.mid(QString("resources/").length())] =
+            QImage(resFile).convertToFormat(
+                QImage::Format_ARGB32_Premultiplied);
+    }
+
+    printf("Kernels: %s%s, threads: %d\n", isaName(FxKernels::getIsa()),
+           parser.isSet("serial") ? " serial" : "",
+           QThreadPool::globalInstance()->maxThreadCount());
+
+    const QList<QPair<QString, double>> sizes = {
+        {"S", 0.5}, {"M", 1.0}, {"L", 2.0}};
+    const QString filter = parser.value("filter");
+
+    if (!parser.isSet("artwork-only")) {
+        const QList<Operation> ops = operations(&config);
+        printf("\n%-12s %-5s %-18s %10s %10s\n", "Image", "Size", "Operation",
+               "ms/call", "MPix/s");
+        for (const auto &size : sizes) {
+            if (parser.isSet("size") && parser.value("size") != size.first) {
+                continue;
+            }
+            const double f = size.second;
+            const QList<QPair<QString, QImage>> images = {
+                {"cover", cover(640 * f, 880 * f)},
+                {"screenshot", screenshot(640 * f, 480 * f)},
+                {"wheel", wheel(800 * f, 300 * f)}};
+            for (const auto &pair : images) {
+                const QImage &image = pair.second;
+                const double mPix = image.width() * image.height() / 1e6;
+                for (const auto &op : ops) {
+                    if (!op.name.contains(filter)) {
+                        continue;
+                    }
+                    // Warms up the thread pool and derived resources
+                    sink = op.run(image).width();
+                    const double us = usPerCall(
+                        runs, [&]() { sink = op.run(image).width(); });
+                    printf("%-12s %-5s %-18s %10.3f %10.1f\n",
+                           pair.first.toUtf8().constData(),
+                           size.first.toUtf8().constData(),
+                           op.name.toUtf8().constData(), us / 1000.0,
+                           mPix / us * 1e6);
+                }
+            }
+        }
+    }
+
+    if (parser.isSet("effects-only")) {
+        return 0;
+    }
+
+    QTemporaryDir tmpDir;
+    config.frontend = "emulationstation";
+    config.inputFolder = tmpDir.path() + "/roms";
+    config.coversFolder = tmpDir.path() + "/covers";
+    config.screenshotsFolder = tmpDir.path() + "/screenshots";
+    config.wheelsFolder = tmpDir.path() + "/wheels";
+    config.marqueesFolder = tmpDir.path() + "/marquees";
+    config.texturesFolder = tmpDir.path() + "/textures";
+    for (const auto &folder :
+         {config.inputFolder, config.coversFolder, config.screenshotsFolder,
+          config.wheelsFolder, config.marqueesFolder, config.texturesFolder}) {
+        QDir().mkpath(folder);
+    }
+
+    GameEntry game;
+    game.path = config.inputFolder + "/game.zip";
+    game.coverData = encode(cover(640, 880));
+    game.screenshotData = encode(screenshot(640, 480));
+    game.wheelData = encode(wheel(800, 300));
+    game.marqueeData = encode(wheel(800, 300));
+    game.textureData = encode(cover(640, 880));
+
+    QStringList artworkFiles = {"artwork.xml"};
+    artworkFiles.append(
+        QDir().entryList({"artwork.xml.example*"}, QDir::Files, QDir::Name));
+    printf("\n%-24s %8s %10s %10s\n", "Artwork", "Games", "ms/game",
+           "games/s");
+    int run = 0;
+    for (const auto &artworkFile : artworkFiles) {
+        if (!artworkFile.contains(filter)) {
+            continue;
+        }
+        QFile file(artworkFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        config.artworkXml = file.readAll();
+        Compositor compositor(&config);
+        if (!compositor.processXml()) {
+            printf("Could not parse '%s'\n", artworkFile.toUtf8().constData());
+            return 1;
+        }
+        // Every game gets its own files, so none is skipped as up to date
+        GameEntry warmup = game;
+        compositor.saveAll(warmup, QString("warmup %1").arg(run));
+        ImageWriter::waitForDone();
+        QElapsedTimer timer;
+        timer.start();
+        for (int a = 0; a < games; ++a) {
+            GameEntry entry = game;
+            compositor.saveAll(entry, QString("game %1 %2").arg(run).arg(a));
+        }
+        const int failed = ImageWriter::waitForDone().size();
+        const double ms = timer.nsecsElapsed() / 1e6 / games;
+        printf("%-24s %8d %10.2f %10.1f\n", artworkFile.toUtf8().constData(),
+               games, ms, 1000.0 / ms);
+        if (failed > 0) {
+            printf("%d file(s) could not be written\n", failed);
+            return 1;
+        }
+        run++;
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+TEMPLATE = app
+TARGET = bench_compositor
+DEPENDPATH += .
+INCLUDEPATH += ../../src
+CONFIG += release
+QT += core gui xml
+QMAKE_CXXFLAGS += -std=c++17
+
+CONFIG(release, debug|release):DEFINES += QT_NO_DEBUG_OUTPUT
+DEFINES+=SRCROOT=\\\"$$PWD/../..\\\"
+
+include(../../VERSION.ini)
+DEFINES+=VERSION=\\\"$$VERSION\\\"
+
+HEADERS += ../../src/compositor.h \
+           ../../src/fileexport.h \
+           ../../src/fxbalance.h \
+           ../../src/fxblur.h \
+           ../../src/fxbrightness.h \
+           ../../src/fxcolorize.h \
+           ../../src/fxcontrast.h \
+           ../../src/fxframe.h \
+           ../../src/fxgamebox.h \
+           ../../src/fxhue.h \
+           ../../src/fxkernels.h \
+           ../../src/fxmask.h \
+           ../../src/fxopacity.h \
+           ../../src/fxrotate.h \
+           ../../src/fxrounded.h \
+           ../../src/fxsaturation.h \
+           ../../src/fxscanlines.h \
+           ../../src/fxshadow.h \
+           ../../src/fxstroke.h \
+           ../../src/gameentry.h \
+           ../../src/imagewriter.h \
+           ../../src/imgtools.h \
+           ../../src/layer.h \
+           ../../src/settings.h \
+           ../../src/taskpool.h
+
+SOURCES += bench_compositor.cpp \
+           ../../src/compositor.cpp \
+           ../../src/fileexport.cpp \
+           ../../src/fxbalance.cpp \
+           ../../src/fxblur.cpp \
+           ../../src/fxbrightness.cpp \
+           ../../src/fxcolorize.cpp \
+           ../../src/fxcontrast.cpp \
+           ../../src/fxframe.cpp \
+           ../../src/fxgamebox.cpp \
+           ../../src/fxhue.cpp \
+           ../../src/fxkernels.cpp \
+           ../../src/fxmask.cpp \
+           ../../src/fxopacity.cpp \
+           ../../src/fxrotate.cpp \
+           ../../src/fxrounded.cpp \
+           ../../src/fxsaturation.cpp \
+           ../../src/fxscanlines.cpp \
+           ../../src/fxshadow.cpp \
+           ../../src/fxstroke.cpp \
+           ../../src/gameentry.cpp \
+           ../../src/imagewriter.cpp \
+           ../../src/imgtools.cpp \
+           ../../src/layer.cpp \
+           ../../src/taskpool.cpp
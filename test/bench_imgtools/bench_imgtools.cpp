@@ -0,0 +1,160 @@
+// Benchmark of the image analysis behind cropToFit and the cache resize.
+//
+// Runs ImgTools::cropToFit() and ImgTools::hasAlpha() on synthetic images
+// shaped like typical artwork and compares them with a scan of every pixel.
+//
+//   ./bench_imgtools -n 200
+//   ./bench_imgtools --image cover.png
+
+#include "imgtools.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QPainter>
+#include <QRandomGenerator>
+
+#include <functional>
+
+// Keeps the compiler from dropping the measured calls
+static volatile int sink = 0;
+
+// Full scan as done before, for comparison
+static QRect fullScanRect(const QImage &image, bool cropBlack) {
+    QRect rect;
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb *line = (const QRgb *)image.constScanLine(y);
+        for (int x = 0; x < image.width(); ++x) {
+            if (qAlpha(line[x]) > 0 &&
+                (!cropBlack || (line[x] & 0x00ffffff) != 0)) {
+                rect |= QRect(x, y, 1, 1);
+            }
+        }
+    }
+    return rect;
+}
+
+static bool fullScanAlpha(const QImage &image) {
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb *line = (const QRgb *)image.constScanLine(y);
+        for (int x = 0; x < image.width(); ++x) {
+            if (qAlpha(line[x]) < 127) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static QImage noise(int width, int height) {
+    QRandomGenerator rnd(4711);
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = (QRgb *)image.scanLine(y);
+        for (int x = 0; x < width; ++x) {
+            line[x] = 0xff000000 | (rnd.generate() & 0x00ffffff);
+        }
+    }
+    return image;
+}
+
+// Opaque cover on a transparent canvas, as after scaling with aspect ratio
+static QImage cover() {
+    QImage image(640, 880, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.drawImage(40, 20, noise(560, 840));
+    return image;
+}
+
+// Opaque screenshot with black borders
+static QImage screenshot() {
+    QImage image(640, 480, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::black);
+    QPainter painter(&image);
+    painter.drawImage(64, 16, noise(512, 448));
+    return image;
+}
+
+// Logo with lots of transparency around and inside
+static QImage wheel() {
+    QImage image(800, 300, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(Qt::red);
+    painter.drawEllipse(120, 60, 560, 180);
+    return image;
+}
+
+static double usPerCall(int runs, const std::function<void()> &call) {
+    QElapsedTimer timer;
+    timer.start();
+    for (int a = 0; a < runs; ++a) {
+        call();
+    }
+    return timer.nsecsElapsed() / 1000.0 / runs;
+}
+
+int main(int argc, char *argv[]) {
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        {{"n", "runs"}, "Runs per measurement.", "N", "100"},
+        {"image", "Also measure this image file.", "FILE"},
+    });
+    parser.process(app);
+    const int runs = qMax(1, parser.value("runs").toInt());
+
+    QList<QPair<QString, QImage>> images = {{"cover", cover()},
+                                            {"screenshot", screenshot()},
+                                            {"wheel", wheel()}};
+    if (parser.isSet("image")) {
+        QImage image(parser.value("image"));
+        if (image.isNull()) {
+            printf("Could not load '%s'\n",
+                   parser.value("image").toUtf8().constData());
+            return 1;
+        }
+        images.append({parser.value("image"),
+                       image.convertToFormat(
+                           QImage::Format_ARGB32_Premultiplied)});
+    }
+
+    printf("%-12s %-10s %12s %12s %8s\n", "Image", "Analysis", "full us",
+           "edge us", "speedup");
+    for (const auto &pair : images) {
+        const QImage &image = pair.second;
+        for (const bool cropBlack : {false, true}) {
+            if (ImgTools::contentRect(image, cropBlack) !=
+                fullScanRect(image, cropBlack)) {
+                printf("Mismatch of the content rect of '%s'\n",
+                       pair.first.toUtf8().constData());
+                return 1;
+            }
+            const double full = usPerCall(
+                runs, [&]() { sink = fullScanRect(image, cropBlack).width(); });
+            const double edge = usPerCall(runs, [&]() {
+                sink = ImgTools::contentRect(image, cropBlack).width();
+            });
+            printf("%-12s %-10s %12.1f %12.1f %7.1fx\n",
+                   pair.first.toUtf8().constData(),
+                   cropBlack ? "cropBlack" : "crop", full, edge, full / edge);
+        }
+        if (ImgTools::hasAlpha(image) != fullScanAlpha(image)) {
+            printf("Mismatch of hasAlpha of '%s'\n",
+                   pair.first.toUtf8().constData());
+            return 1;
+        }
+        const double full =
+            usPerCall(runs, [&]() { sink = fullScanAlpha(image); });
+        const double simd =
+            usPerCall(runs, [&]() { sink = ImgTools::hasAlpha(image); });
+        printf("%-12s %-10s %12.1f %12.1f %7.1fx\n",
+               pair.first.toUtf8().constData(), "hasAlpha", full, simd,
+               full / simd);
+    }
+    return 0;
+}
@@ -0,0 +1,17 @@
+TEMPLATE = app
+TARGET = bench_imgtools
+DEPENDPATH += .
+INCLUDEPATH += ../../src
+CONFIG += release
+QT += core gui
+QMAKE_CXXFLAGS += -std=c++17
+
+CONFIG(release, debug|release):DEFINES += QT_NO_DEBUG_OUTPUT
+
+include(../../VERSION.ini)
+DEFINES+=VERSION=\\\"$$VERSION\\\"
+
+HEADERS += ../../src/imgtools.h
+
+SOURCES += bench_imgtools.cpp \
+           ../../src/imgtools.cpp
@@ -0,0 +1,228 @@
+// End-to-end scraping throughput benchmark against a local stand-in service.
+//
+// Generates a synthetic romset, starts MockService on localhost, points
+// NetManager at it and runs the regular ScraperWorker threads including the
+// resource cache. Reports ROMs/s, request counts and bytes per route and the
+// wall time per stage.
+//
+//   ./bench_scraping -s screenscraper -n 500 -t 4 --latency 80
+//   ./bench_scraping --serve 8642   (stand-in only, use with 'scraperBaseUrl')
+
+#include "cache.h"
+#include "gameentry.h"
+#include "mockservice.h"
+#include "netmanager.h"
+#include "platform.h"
+#include "queue.h"
+#include "scraperworker.h"
+#include "settings.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QThread>
+
+static void printStats(MockService *service, qint64 scrapeMs) {
+    QMap<QString, MockStats> stats = service->getStats();
+    MockStats total;
+    printf("\n%-10s %10s %10s %10s %14s\n", "Route", "Requests", "Throttled",
+           "Failed", "Bytes");
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        printf("%-10s %10d %10d %10d %14lld\n", it.key().toUtf8().constData(),
+               it.value().requests, it.value().throttled, it.value().failed,
+               it.value().bytes);
+        total.requests += it.value().requests;
+        total.throttled += it.value().throttled;
+        total.failed += it.value().failed;
+        total.bytes += it.value().bytes;
+    }
+    printf("%-10s %10d %10d %10d %14lld\n", "total", total.requests,
+           total.throttled, total.failed, total.bytes);
+    if (scrapeMs > 0) {
+        printf("\nRequests/s: %.2f, MB/s: %.2f\n",
+               total.requests * 1000.0 / scrapeMs,
+               total.bytes / 1000.0 / scrapeMs);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    qRegisterMetaType<GameEntry>("GameEntry");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        {{"s", "scraper"},
+         "Scraping module: screenscraper, thegamesdb or igdb.",
+         "MODULE",
+         "thegamesdb"},
+        {{"p", "platform"}, "Platform of the romset.", "PLATFORM", "snes"},
+        {{"n", "roms"}, "Number of synthetic ROMs.", "N", "200"},
+        {{"t", "threads"}, "Scraping threads.", "N", "4"},
+        {"latency", "Latency of every response in ms.", "MS", "50"},
+        {"rate-limit", "Max requests per second, 0 = off.", "N", "0"},
+        {"error-rate", "Percentage of requests failing with 503.", "PCT",
+         "0"},
+        {"image-size", "Size of served images.", "WxH", "640x480"},
+        {"video-size", "Size of served videos in KiB.", "KIB", "1024"},
+        {"videos", "Also scrape videos."},
+        {"manuals", "Also scrape manuals."},
+        {"serve", "Only run the stand-in service on PORT.", "PORT"},
+    });
+    parser.process(app);
+
+    // Run from the source root so platform and scraper data files are found
+    QDir::setCurrent(SRCROOT);
+    if (!Platform::get().loadConfig()) {
+        return 1;
+    }
+
+    Settings config;
+    config.scraper = parser.value("scraper");
+    config.platform = parser.value("platform");
+    config.threads = qMax(1, parser.value("threads").toInt());
+    config.videos = parser.isSet("videos");
+    config.manuals = parser.isSet("manuals");
+    config.minMatch = 0;
+    config.verbosity = 0;
+    config.maxFails = 200;
+    config.regionPrios = {"wor", "us", "eu", "jp"};
+    config.langPrios = {"en"};
+    if (config.scraper == "igdb") {
+        config.user = "mock";
+        config.igdbToken = "mock";
+    }
+    QFile artworkFile("artwork.xml");
+    if (artworkFile.open(QIODevice::ReadOnly)) {
+        config.artworkXml = artworkFile.readAll();
+    }
+
+    MockOptions options;
+    options.latency = parser.value("latency").toInt();
+    options.rateLimit = parser.value("rate-limit").toInt();
+    options.errorRate = parser.value("error-rate").toInt();
+    QStringList size = parser.value("image-size").split("x");
+    if (size.size() == 2) {
+        options.imageSize = QSize(size.at(0).toInt(), size.at(1).toInt());
+    }
+    options.videoSize = parser.value("video-size").toInt() * 1024;
+    options.platformName = config.platform;
+    options.tgdbPlatformId =
+        Platform::get().getPlatformIdOnScraper(config.platform, "thegamesdb");
+    options.igdbPlatformId = 1;
+
+    QThread serviceThread;
+    MockService service(options);
+    service.moveToThread(&serviceThread);
+    serviceThread.start();
+    int port = -1;
+    QMetaObject::invokeMethod(
+        &service, "start", Qt::BlockingQueuedConnection,
+        Q_RETURN_ARG(int, port),
+        Q_ARG(int, parser.isSet("serve") ? parser.value("serve").toInt() : 0));
+    if (port == -1) {
+        printf("Could not start stand-in service\n");
+        return 1;
+    }
+    printf("Stand-in service listening on http://127.0.0.1:%d\n", port);
+    if (parser.isSet("serve")) {
+        return app.exec();
+    }
+
+    QElapsedTimer stage;
+    stage.start();
+    QTemporaryDir tmpDir;
+    QDir romDir(tmpDir.path());
+    romDir.mkpath("roms");
+    int totalRoms = qMax(1, parser.value("roms").toInt());
+    QSharedPointer<Queue> queue = QSharedPointer<Queue>(new Queue());
+    QRandomGenerator rnd(4711);
+    for (int a = 1; a <= totalRoms; ++a) {
+        QFile rom(tmpDir.path() +
+                  QString("/roms/Mock Game %1 (World).zip").arg(a, 5, 10,
+                                                                 QChar('0')));
+        if (rom.open(QIODevice::WriteOnly)) {
+            QByteArray content(4096, '\0');
+            for (auto &c : content) {
+                c = (char)rnd.bounded(256);
+            }
+            rom.write(content);
+            rom.close();
+        }
+        queue->append(QFileInfo(rom));
+    }
+    config.cacheFolder = tmpDir.path() + "/cache";
+    QSharedPointer<Cache> cache =
+        QSharedPointer<Cache>(new Cache(config.cacheFolder));
+    cache->createFolders(config.scraper);
+    cache->read();
+    qint64 setupMs = stage.restart();
+
+    QSharedPointer<NetManager> manager =
+        QSharedPointer<NetManager>(new NetManager());
+    manager->setBaseUrlOverride(QUrl("http://127.0.0.1:" +
+                                     QString::number(port)));
+
+    int found = 0;
+    int done = 0;
+    int doneThreads = 0;
+    QList<QThread *> threadList;
+    for (int curThread = 1; curThread <= config.threads; ++curThread) {
+        QThread *thread = new QThread;
+        ScraperWorker *worker = new ScraperWorker(queue, cache, manager, config,
+                                                  QString::number(curThread));
+        worker->moveToThread(thread);
+        QObject::connect(thread, &QThread::started, worker,
+                         &ScraperWorker::run);
+        QObject::connect(worker, &ScraperWorker::entryReady, &app,
+                         [&](const GameEntry &entry, const QString &,
+                             const QString &) {
+                             done++;
+                             if (entry.found) {
+                                 found++;
+                             }
+                         });
+        QObject::connect(worker, &ScraperWorker::allDone, &app, [&]() {
+            if (++doneThreads == threadList.size()) {
+                app.quit();
+            }
+        });
+        QObject::connect(thread, &QThread::finished, worker,
+                         &ScraperWorker::deleteLater);
+        threadList.append(thread);
+    }
+    for (const auto thread : threadList) {
+        thread->start();
+    }
+    app.exec();
+    qint64 scrapeMs = stage.restart();
+
+    for (const auto thread : threadList) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+    cache->write();
+    qint64 cacheMs = stage.restart();
+
+    printf("\nModule: %s, platform: %s, threads: %d, latency: %d ms\n",
+           config.scraper.toUtf8().constData(),
+           config.platform.toUtf8().constData(), config.threads,
+           options.latency);
+    printf("ROMs: %d, processed: %d, found: %d\n", totalRoms, done, found);
+    printf("\n%-12s %10s\n", "Stage", "ms");
+    printf("%-12s %10lld\n", "setup", setupMs);
+    printf("%-12s %10lld\n", "scrape", scrapeMs);
+    printf("%-12s %10lld\n", "cache write", cacheMs);
+    printf("%-12s %10lld\n", "total", setupMs + scrapeMs + cacheMs);
+    printf("\nROMs/s: %.2f\n", done * 1000.0 / qMax<qint64>(1, scrapeMs));
+    printStats(&service, scrapeMs);
+
+    serviceThread.quit();
+    serviceThread.wait();
+    return 0;
+}
@@ -0,0 +1,120 @@
+TEMPLATE = app
+TARGET = bench_scraping
+DEPENDPATH += .
+INCLUDEPATH += ../../src
+CONFIG += release
+QT += core network sql xml
+QMAKE_CXXFLAGS += -std=c++17
+
+CONFIG(release, debug|release):DEFINES += QT_NO_DEBUG_OUTPUT
+PREFIX = /usr/local
+DEFINES+=PREFIX=\\\"$$PREFIX\\\"
+DEFINES+=SRCROOT=\\\"$$PWD/../..\\\"
+
+include(../../VERSION.ini)
+DEFINES+=VERSION=\\\"$$VERSION\\\"
+
+HEADERS += mockservice.h \
+           ../../src/netmanager.h \
+           ../../src/netcomm.h \
+           ../../src/xmlreader.h \
+           ../../src/settings.h \
+           ../../src/cli.h \
+           ../../src/compositor.h \
+           ../../src/config.h \
+           ../../src/strtools.h \
+           ../../src/imgtools.h \
+           ../../src/esgamelist.h \
+           ../../src/scraperworker.h \
+           ../../src/cache.h \
+           ../../src/localscraper.h \
+           ../../src/importscraper.h \
+           ../../src/gameentry.h \
+           ../../src/abstractscraper.h \
+           ../../src/openretro.h \
+           ../../src/thegamesdb.h \
+           ../../src/zxinfodk.h \
+           ../../src/screenscraper.h \
+           ../../src/crc32.h \
+           ../../src/mobygames.h \
+           ../../src/gamebase.h \
+           ../../src/igdb.h \
+           ../../src/arcadedb.h \
+           ../../src/platform.h \
+           ../../src/layer.h \
+           ../../src/fxshadow.h \
+           ../../src/fxblur.h \
+           ../../src/fxmask.h \
+           ../../src/fxframe.h \
+           ../../src/fxrounded.h \
+           ../../src/fxstroke.h \
+           ../../src/fxbrightness.h \
+           ../../src/fxcontrast.h \
+           ../../src/fileexport.h \
+           ../../src/fxbalance.h \
+           ../../src/fxopacity.h \
+           ../../src/fxgamebox.h \
+           ../../src/fxhue.h \
+           ../../src/fxsaturation.h \
+           ../../src/fxcolorize.h \
+           ../../src/fxrotate.h \
+           ../../src/fxscanlines.h \
+           ../../src/fxkernels.h \
+           ../../src/taskpool.h \
+           ../../src/imagewriter.h \
+           ../../src/videoconverter.h \
+           ../../src/nametools.h \
+           ../../src/queue.h
+
+SOURCES += bench_scraping.cpp \
+           mockservice.cpp \
+           ../../src/netmanager.cpp \
+           ../../src/netcomm.cpp \
+           ../../src/xmlreader.cpp \
+           ../../src/settings.cpp \
+           ../../src/cli.cpp \
+           ../../src/compositor.cpp \
+           ../../src/config.cpp \
+           ../../src/strtools.cpp \
+           ../../src/imgtools.cpp \
+           ../../src/esgamelist.cpp \
+           ../../src/scraperworker.cpp \
+           ../../src/cache.cpp \
+           ../../src/localscraper.cpp \
+           ../../src/importscraper.cpp \
+           ../../src/gameentry.cpp \
+           ../../src/abstractscraper.cpp \
+           ../../src/openretro.cpp \
+           ../../src/thegamesdb.cpp \
+           ../../src/zxinfodk.cpp \
+           ../../src/screenscraper.cpp \
+           ../../src/crc32.cpp \
+           ../../src/mobygames.cpp \
+           ../../src/gamebase.cpp \
+           ../../src/igdb.cpp \
+           ../../src/arcadedb.cpp \
+           ../../src/platform.cpp \
+           ../../src/layer.cpp \
+           ../../src/fxshadow.cpp \
+           ../../src/fxblur.cpp \
+           ../../src/fxmask.cpp \
+           ../../src/fxframe.cpp \
+           ../../src/fxrounded.cpp \
+           ../../src/fxstroke.cpp \
+           ../../src/fxbrightness.cpp \
+           ../../src/fxcontrast.cpp \
+           ../../src/fileexport.cpp \
+           ../../src/fxbalance.cpp \
+           ../../src/fxopacity.cpp \
+           ../../src/fxgamebox.cpp \
+           ../../src/fxhue.cpp \
+           ../../src/fxsaturation.cpp \
+           ../../src/fxcolorize.cpp \
+           ../../src/fxrotate.cpp \
+           ../../src/fxscanlines.cpp \
+           ../../src/fxkernels.cpp \
+           ../../src/taskpool.cpp \
+           ../../src/imagewriter.cpp \
+           ../../src/videoconverter.cpp \
+           ../../src/nametools.cpp \
+           ../../src/queue.cpp
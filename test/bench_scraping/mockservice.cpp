@@ -0,0 +1,365 @@
+#include "mockservice.h"
+
+#include <QBuffer>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QTimer>
+
+MockService::MockService(const MockOptions &options) : options(options) {
+    // Media payloads are generated once and served for every media url
+    QImage canvas(options.imageSize, QImage::Format_RGB32);
+    QRandomGenerator rnd(42);
+    for (int y = 0; y < canvas.height(); ++y) {
+        QRgb *line = (QRgb *)canvas.scanLine(y);
+        for (int x = 0; x < canvas.width(); ++x) {
+            int noise = rnd.bounded(32);
+            line[x] = qRgb((x * 255 / canvas.width() + noise) & 0xff,
+                           (y * 255 / canvas.height() + noise) & 0xff,
+                           (128 + noise) & 0xff);
+        }
+    }
+    QBuffer buffer(&image);
+    buffer.open(QIODevice::WriteOnly);
+    canvas.save(&buffer, "PNG");
+
+    video.resize(options.videoSize);
+    for (int a = 0; a < video.size(); ++a) {
+        video[a] = (char)rnd.bounded(256);
+    }
+    manual = "%PDF-1.4\n";
+    manual.append(video.left(qMax(0, options.manualSize - manual.size())));
+}
+
+int MockService::start(int port) {
+    if (!listen(QHostAddress::LocalHost, port)) {
+        return -1;
+    }
+    baseUrl = "http://127.0.0.1:" + QString::number(serverPort());
+    return serverPort();
+}
+
+QMap<QString, MockStats> MockService::getStats() {
+    QMutexLocker locker(&statsMutex);
+    return stats;
+}
+
+void MockService::incomingConnection(qintptr handle) {
+    QTcpSocket *socket = new QTcpSocket(this);
+    socket->setSocketDescriptor(handle);
+    connect(socket, &QTcpSocket::readyRead, this, &MockService::readRequest);
+    connect(socket, &QTcpSocket::disconnected, this, &MockService::dropSocket);
+}
+
+void MockService::dropSocket() {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    buffers.remove(socket);
+    socket->deleteLater();
+}
+
+void MockService::readRequest() {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    QByteArray &buffer = buffers[socket];
+    buffer.append(socket->readAll());
+    while (true) {
+        int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd == -1) {
+            return;
+        }
+        QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+        QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        if (requestLine.size() < 2) {
+            socket->disconnectFromHost();
+            return;
+        }
+        int contentLength = 0;
+        for (const auto &line : lines) {
+            if (line.toLower().startsWith("content-length:")) {
+                contentLength = line.mid(15).trimmed().toInt();
+            }
+        }
+        if (buffer.size() < headerEnd + 4 + contentLength) {
+            return;
+        }
+        QByteArray body = buffer.mid(headerEnd + 4, contentLength);
+        buffer.remove(0, headerEnd + 4 + contentLength);
+        handle(socket, requestLine.at(0),
+               QUrl(baseUrl + QString::fromUtf8(requestLine.at(1))), body);
+    }
+}
+
+void MockService::handle(QTcpSocket *socket, const QByteArray &method,
+                         const QUrl &url, const QByteArray &body) {
+    QString path = url.path();
+    QUrlQuery query(url);
+
+    QString route = "other";
+    if (path.endsWith("/jeuInfos.php") || path.endsWith("/ByGameName") ||
+        (method == "POST" && (path.contains("/search") ||
+                              path.endsWith("/multiquery")))) {
+        route = "search";
+    } else if (path.endsWith("/ByGameID") ||
+               (method == "POST" && path.contains("/games"))) {
+        route = "game";
+    } else if (path.startsWith("/media/") && path.endsWith("/video")) {
+        route = "video";
+    } else if (path.startsWith("/media/") && path.endsWith("/manual")) {
+        route = "manual";
+    } else if (path.startsWith("/media/") || path.startsWith("/images/") ||
+               path.contains("/image/upload/")) {
+        route = "image";
+    }
+
+    if (throttle()) {
+        reply(socket, route, 429, "text/plain", "Too Many Requests");
+        return;
+    }
+    if (options.errorRate > 0 &&
+        (int)QRandomGenerator::global()->bounded(100) < options.errorRate) {
+        reply(socket, route, 503, "text/plain", QByteArray());
+        return;
+    }
+
+    if (path.endsWith("/jeuInfos.php")) {
+        reply(socket, route, 200, "application/json", ssGame(query));
+    } else if (path.endsWith("/ByGameName")) {
+        reply(socket, route, 200, "application/json", tgdbSearch(query));
+    } else if (path.endsWith("/ByGameID")) {
+        reply(socket, route, 200, "application/json", tgdbGame(query));
+    } else if (path.endsWith("/multiquery")) {
+        reply(socket, route, 200, "application/json", igdbMultiquery(body));
+    } else if (route == "search") {
+        reply(socket, route, 200, "application/json", igdbSearch(body));
+    } else if (route == "game") {
+        reply(socket, route, 200, "application/json", igdbGame(body));
+    } else if (route == "video") {
+        reply(socket, route, 200, "video/mp4", video);
+    } else if (route == "manual") {
+        reply(socket, route, 200, "application/pdf", manual);
+    } else if (route == "image") {
+        reply(socket, route, 200, "image/png", image);
+    } else {
+        reply(socket, route, 404, "text/plain", QByteArray());
+    }
+}
+
+void MockService::reply(QTcpSocket *socket, const QString &route, int status,
+                        const QByteArray &contentType, const QByteArray &data) {
+    {
+        QMutexLocker locker(&statsMutex);
+        MockStats &s = stats[route];
+        s.requests++;
+        if (status == 429) {
+            s.throttled++;
+        } else if (status >= 500) {
+            s.failed++;
+        }
+        s.bytes += data.size();
+    }
+
+    QByteArray reason = "OK";
+    if (status == 404) {
+        reason = "Not Found";
+    } else if (status == 429) {
+        reason = "Too Many Requests";
+    } else if (status == 503) {
+        reason = "Service Unavailable";
+    }
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + " " +
+                          reason + "\r\nContent-Type: " + contentType +
+                          "\r\nContent-Length: " +
+                          QByteArray::number(data.size()) + "\r\n";
+    if (status == 429) {
+        response.append("Retry-After: 1\r\n");
+    }
+    response.append("\r\n");
+    response.append(data);
+    QTimer::singleShot(options.latency, socket,
+                       [socket, response]() { socket->write(response); });
+}
+
+bool MockService::throttle() {
+    if (options.rateLimit <= 0) {
+        return false;
+    }
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    while (!recent.isEmpty() && recent.first() <= now - 1000) {
+        recent.removeFirst();
+    }
+    if (recent.size() >= options.rateLimit) {
+        return true;
+    }
+    recent.append(now);
+    return false;
+}
+
+int MockService::gameId(const QString &title) {
+    // FNV-1a, stable across runs unlike qHash()
+    quint32 hash = 2166136261u;
+    for (const auto c : title.toLower().toUtf8()) {
+        hash = (hash ^ (quint8)c) * 16777619u;
+    }
+    int id = (int)(hash & 0x7fffff) + 1;
+    titles[id] = title;
+    return id;
+}
+
+QString MockService::mediaUrl(int id, const QString &type) {
+    return baseUrl + "/media/" + QString::number(id) + "/" + type;
+}
+
+QByteArray MockService::ssGame(const QUrlQuery &query) {
+    QString title = query.queryItemValue("romnom", QUrl::FullyDecoded);
+    title.remove(QRegularExpression("\\.[^. ]+$"));
+    title.remove(QRegularExpression("\\s*[\\(\\[].*$"));
+    if (title.isEmpty()) {
+        title = "Mock Game " + query.queryItemValue("crc");
+    }
+    int id = gameId(title);
+
+    QJsonArray medias;
+    const QList<QPair<QString, QString>> types = {
+        {"box-2D", "cover"},   {"ss", "screenshot"},
+        {"wheel", "wheel"},    {"screenmarquee", "marquee"},
+        {"support-2D", "texture"}};
+    for (const auto &t : types) {
+        medias.append(QJsonObject{{"type", t.first},
+                                  {"region", "wor"},
+                                  {"url", mediaUrl(id, t.second)},
+                                  {"format", "png"}});
+    }
+    medias.append(QJsonObject{{"type", "video-normalized"},
+                              {"url", mediaUrl(id, "video")},
+                              {"format", "mp4"}});
+    medias.append(QJsonObject{{"type", "manuel"},
+                              {"region", "wor"},
+                              {"url", mediaUrl(id, "manual")},
+                              {"format", "pdf"}});
+
+    QJsonObject jeu{
+        {"id", QString::number(id)},
+        {"noms", QJsonArray{QJsonObject{{"region", "wor"}, {"text", title}}}},
+        {"systeme", QJsonObject{{"id", "1"}, {"text", options.platformName}}},
+        {"editeur", QJsonObject{{"text", "Mock Publisher"}}},
+        {"developpeur", QJsonObject{{"text", "Mock Developer"}}},
+        {"joueurs", QJsonObject{{"text", "1-2"}}},
+        {"note", QJsonObject{{"text", "16"}}},
+        {"synopsis",
+         QJsonArray{QJsonObject{
+             {"langue", "en"},
+             {"text", "Synthetic description of " + title + "."}}}},
+        {"dates",
+         QJsonArray{QJsonObject{{"region", "wor"}, {"text", "1994-03-01"}}}},
+        {"medias", medias}};
+    QJsonObject root{
+        {"header", QJsonObject{{"success", "true"}}},
+        {"response", QJsonObject{{"jeu", jeu}}}};
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QByteArray MockService::tgdbSearch(const QUrlQuery &query) {
+    QString title = query.queryItemValue("name", QUrl::FullyDecoded);
+    QJsonObject game{{"id", gameId(title)},
+                     {"game_title", title},
+                     {"release_date", "1994-03-01"},
+                     {"platform", options.tgdbPlatformId}};
+    QJsonObject root{
+        {"status", "Success"},
+        {"remaining_monthly_allowance", 1000000},
+        {"data", QJsonObject{{"count", 1}, {"games", QJsonArray{game}}}}};
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QByteArray MockService::tgdbGame(const QUrlQuery &query) {
+    int id = query.queryItemValue("id").toInt();
+    QString title = titles.value(id, "Mock Game");
+    QJsonObject game{
+        {"id", id},
+        {"game_title", title},
+        {"release_date", "1994-03-01"},
+        {"players", 2},
+        {"overview", "Synthetic description of " + title + "."},
+        {"rating", "E - Everyone"},
+        {"developers", QJsonArray{1}},
+        {"publishers", QJsonArray{1}},
+        {"genres", QJsonArray{1}},
+        {"platform", options.tgdbPlatformId}};
+    QJsonObject root{
+        {"status", "Success"},
+        {"remaining_monthly_allowance", 1000000},
+        {"data", QJsonObject{{"count", 1}, {"games", QJsonArray{game}}}}};
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QByteArray MockService::igdbSearch(const QByteArray &body) {
+    QRegularExpressionMatch match =
+        QRegularExpression("search \"([^\"]*)\"").match(QString(body));
+    QString title = match.hasMatch() ? match.captured(1) : "Mock Game";
+    return QJsonDocument(igdbSearchResult(title))
+        .toJson(QJsonDocument::Compact);
+}
+
+QByteArray MockService::igdbMultiquery(const QByteArray &body) {
+    QRegularExpressionMatchIterator it =
+        QRegularExpression("query search \"([^\"]*)\" \\{[^}]*search "
+                           "\"([^\"]*)\"")
+            .globalMatch(QString(body));
+    QJsonArray root;
+    while (it.hasNext()) {
+        QRegularExpressionMatch match = it.next();
+        root.append(
+            QJsonObject{{"name", match.captured(1)},
+                        {"result", igdbSearchResult(match.captured(2))}});
+    }
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QJsonArray MockService::igdbSearchResult(const QString &title) {
+    QJsonObject game{
+        {"id", gameId(title)},
+        {"name", title},
+        {"platforms", QJsonArray{QJsonObject{
+                          {"id", options.igdbPlatformId},
+                          {"name", options.platformName}}}},
+        {"release_dates",
+         QJsonArray{QJsonObject{{"date", 762480000},
+                                {"platform", options.igdbPlatformId}}}}};
+    return QJsonArray{QJsonObject{{"id", 1}, {"game", game}}};
+}
+
+QByteArray MockService::igdbGame(const QByteArray &body) {
+    QRegularExpressionMatch match =
+        QRegularExpression("where id = (\\d+)").match(QString(body));
+    int id = match.hasMatch() ? match.captured(1).toInt() : 1;
+    QString title = titles.value(id, "Mock Game");
+    QString imgUrl = "//images.igdb.com/igdb/image/upload/t_thumb/" +
+                     QString::number(id);
+    QJsonArray screenshots;
+    for (int a = 0; a < 4; ++a) {
+        screenshots.append(
+            QJsonObject{{"url", imgUrl + "_" + QString::number(a) + ".jpg"}});
+    }
+    QJsonObject game{
+        {"id", id},
+        {"cover", QJsonObject{{"url", imgUrl + ".jpg"}}},
+        {"screenshots", screenshots},
+        {"summary", "Synthetic description of " + title + "."},
+        {"total_rating", 80.0},
+        {"genres", QJsonArray{QJsonObject{{"name", "Platform"}}}},
+        {"game_modes", QJsonArray{QJsonObject{{"id", 1}}}},
+        {"involved_companies",
+         QJsonArray{QJsonObject{
+             {"company", QJsonObject{{"name", "Mock Developer"}}},
+             {"developer", true},
+             {"publisher", true}}}},
+        {"release_dates",
+         QJsonArray{QJsonObject{{"date", 762480000},
+                                {"platform", options.igdbPlatformId},
+                                {"region", 8}}}}};
+    return QJsonDocument(QJsonArray{game}).toJson(QJsonDocument::Compact);
+}
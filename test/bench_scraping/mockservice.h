@@ -0,0 +1,87 @@
+#ifndef MOCKSERVICE_H
+#define MOCKSERVICE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QSize>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrl>
+#include <QUrlQuery>
+
+// Local HTTP/1.1 stand-in for the ScreenScraper, TheGamesDB and IGDB APIs.
+// Skyscraper is pointed at it with NetManager::setBaseUrlOverride(). Every
+// query resolves to a synthetic game named after the search string, media
+// urls point back to this service.
+struct MockOptions {
+    int latency = 50;   // ms added to every response
+    int rateLimit = 0;  // max requests per second, 0 = unlimited
+    int errorRate = 0;  // percentage of requests answered with 503
+    QSize imageSize = QSize(640, 480);
+    int videoSize = 1024 * 1024;
+    int manualSize = 256 * 1024;
+    int tgdbPlatformId = -1;
+    int igdbPlatformId = -1;
+    QString platformName;
+};
+
+struct MockStats {
+    int requests = 0;
+    int throttled = 0;
+    int failed = 0;
+    qint64 bytes = 0;
+};
+
+class MockService : public QTcpServer {
+    Q_OBJECT
+
+public:
+    MockService(const MockOptions &options);
+    QMap<QString, MockStats> getStats();
+
+public slots:
+    int start(int port);
+
+protected:
+    void incomingConnection(qintptr handle) override;
+
+private slots:
+    void readRequest();
+    void dropSocket();
+
+private:
+    void handle(QTcpSocket *socket, const QByteArray &method, const QUrl &url,
+                const QByteArray &body);
+    void reply(QTcpSocket *socket, const QString &route, int status,
+               const QByteArray &contentType, const QByteArray &data);
+    bool throttle();
+
+    QByteArray ssGame(const QUrlQuery &query);
+    QByteArray tgdbSearch(const QUrlQuery &query);
+    QByteArray tgdbGame(const QUrlQuery &query);
+    QByteArray igdbSearch(const QByteArray &body);
+    QByteArray igdbMultiquery(const QByteArray &body);
+    QJsonArray igdbSearchResult(const QString &title);
+    QByteArray igdbGame(const QByteArray &body);
+
+    int gameId(const QString &title);
+    QString mediaUrl(int id, const QString &type);
+
+    MockOptions options;
+    QByteArray image;
+    QByteArray video;
+    QByteArray manual;
+    QMap<QTcpSocket *, QByteArray> buffers;
+    QMap<int, QString> titles;
+    QList<qint64> recent;
+    QString baseUrl;
+
+    QMutex statsMutex;
+    QMap<QString, MockStats> stats;
+};
+
+#endif // MOCKSERVICE_H
@@ -0,0 +1,366 @@
+#include "fxbalance.h"
+#include "fxblur.h"
+#include "fxbrightness.h"
+#include "fxcolorize.h"
+#include "fxcontrast.h"
+#include "fxhue.h"
+#include "fxkernels.h"
+#include "fxopacity.h"
+#include "fxsaturation.h"
+#include "layer.h"
+
+#include <QColor>
+#include <QRandomGenerator>
+#include <QTest>
+#include <cmath>
+#include <utility>
+
+class TestFxKernels : public QObject {
+    Q_OBJECT
+
+private:
+    // Random premultiplied pixels incl. fully opaque and fully transparent
+    // ones. Odd width so the SIMD tails are covered too
+    QImage randomImage() {
+        QRandomGenerator rnd(4711);
+        QImage img(37, 11, QImage::Format_ARGB32_Premultiplied);
+        for (int y = 0; y < img.height(); ++y) {
+            QRgb *line = (QRgb *)img.scanLine(y);
+            for (int x = 0; x < img.width(); ++x) {
+                int a = rnd.bounded(256);
+                if (x % 5 == 0) {
+                    a = 255;
+                } else if (x % 7 == 0) {
+                    a = 0;
+                }
+                line[x] = qRgba(rnd.bounded(a + 1), rnd.bounded(a + 1),
+                                rnd.bounded(a + 1), a);
+            }
+        }
+        return img;
+    }
+
+    // Straight colour semantics in floating point, then premultiplied
+    static int reference(int p, int a, int mul, int offset) {
+        double v = p * mul / 256.0 + offset * a / 255.0;
+        return (int)std::lround(qBound(0.0, v, (double)a));
+    }
+
+    // Opaque pixels covering a good part of the RGB cube
+    QImage opaqueImage() {
+        QImage img(256, 64, QImage::Format_ARGB32_Premultiplied);
+        for (int y = 0; y < img.height(); ++y) {
+            QRgb *line = (QRgb *)img.scanLine(y);
+            for (int x = 0; x < img.width(); ++x) {
+                line[x] = qRgb(x, y * 4, (x * 7 + y * 13) % 256);
+            }
+        }
+        return img;
+    }
+
+    static bool nearlyEqual(QRgb a, QRgb b) {
+        return qAbs(qRed(a) - qRed(b)) <= 1 &&
+               qAbs(qGreen(a) - qGreen(b)) <= 1 &&
+               qAbs(qBlue(a) - qBlue(b)) <= 1 && qAlpha(a) == qAlpha(b);
+    }
+
+    QList<QPair<QVector<int>, QVector<int>>> params = {
+        {{256, 256, 256, 256}, {0, 0, 0}},
+        {{256, 256, 256, 256}, {40, 40, 40}},
+        {{256, 256, 256, 256}, {-255, 100, 255}},
+        {{300, 300, 300, 256}, {0, 0, 0}},
+        {{65535, 1000, 0, 256}, {0, 0, 0}},
+        {{128, 128, 128, 128}, {0, 0, 0}},
+        {{64, 64, 64, 64}, {0, 0, 0}}};
+
+private slots:
+    void testReference() {
+        const QImage src = randomImage();
+        FxKernels::setIsa(FxKernels::ISA_SCALAR);
+        for (const auto &p : params) {
+            QImage img = src;
+            FxKernels::scaleOffset(img, p.first.constData(),
+                                   p.second.constData());
+            for (int y = 0; y < img.height(); ++y) {
+                const QRgb *in = (const QRgb *)src.constScanLine(y);
+                const QRgb *out = (const QRgb *)img.constScanLine(y);
+                for (int x = 0; x < img.width(); ++x) {
+                    const int a = qAlpha(in[x]);
+                    const int expA = (int)std::lround(a * p.first[3] / 256.0);
+                    QVERIFY(qAbs(qAlpha(out[x]) - expA) <= 1);
+                    const int channels[3] = {qRed(in[x]), qGreen(in[x]),
+                                             qBlue(in[x])};
+                    const int result[3] = {qRed(out[x]), qGreen(out[x]),
+                                           qBlue(out[x])};
+                    for (int c = 0; c < 3; ++c) {
+                        int exp = reference(channels[c], a, p.first[c],
+                                            p.second[c]);
+                        QVERIFY2(qAbs(result[c] - exp) <= 1,
+                                 qPrintable(QString("pixel %1,%2 channel %3")
+                                                .arg(x)
+                                                .arg(y)
+                                                .arg(c)));
+                    }
+                }
+            }
+        }
+    }
+
+    void testIsasMatchScalar() {
+        const QImage src = randomImage();
+        const FxKernels::Isa best = FxKernels::getIsa();
+        for (const auto isa : {FxKernels::ISA_SSE2, FxKernels::ISA_AVX2,
+                               FxKernels::ISA_NEON}) {
+            if (!FxKernels::isSupported(isa)) {
+                continue;
+            }
+            for (const auto &p : params) {
+                QImage expected = src;
+                FxKernels::setIsa(FxKernels::ISA_SCALAR);
+                FxKernels::scaleOffset(expected, p.first.constData(),
+                                       p.second.constData());
+                QImage img = src;
+                FxKernels::setIsa(isa);
+                FxKernels::scaleOffset(img, p.first.constData(),
+                                       p.second.constData());
+                QCOMPARE(img, expected);
+            }
+        }
+        FxKernels::setIsa(best);
+    }
+
+    void testBrightnessTranslucent() {
+        // Straight grey 100 at half opacity must become grey 150, not be
+        // darkened by premultiplying twice
+        QImage img(1, 1, QImage::Format_ARGB32_Premultiplied);
+        img.setPixel(0, 0, qPremultiply(qRgba(100, 100, 100, 128)));
+        Layer layer;
+        layer.setDelta(50);
+        FxBrightness effect;
+        QRgb out = qUnpremultiply(effect.applyEffect(img, layer).pixel(0, 0));
+        QVERIFY(qAbs(qRed(out) - 150) <= 2);
+        QCOMPARE(qAlpha(out), 128);
+    }
+
+    void testHueMatchesQColor() {
+        const QImage src = opaqueImage();
+        for (const int delta : {0, 1, 90, 180, 359}) {
+            Layer layer;
+            layer.setDelta(delta);
+            const QImage img = FxHue().applyEffect(src, layer);
+            for (int y = 0; y < src.height(); ++y) {
+                for (int x = 0; x < src.width(); ++x) {
+                    QColor color(src.pixel(x, y));
+                    color.setHsv(color.hue() + delta, color.saturation(),
+                                 color.value());
+                    QVERIFY(nearlyEqual(img.pixel(x, y), color.rgb()));
+                }
+            }
+        }
+    }
+
+    void testSaturationMatchesQColor() {
+        const QImage src = opaqueImage();
+        for (const int delta : {-255, -40, 0, 60, 255}) {
+            Layer layer;
+            layer.setDelta(delta);
+            const QImage img = FxSaturation().applyEffect(src, layer);
+            for (int y = 0; y < src.height(); ++y) {
+                for (int x = 0; x < src.width(); ++x) {
+                    QColor color(src.pixel(x, y));
+                    color.setHsl(
+                        color.hue(),
+                        qBound(0, color.hslSaturation() + delta, 255),
+                        color.lightness());
+                    QVERIFY(nearlyEqual(img.pixel(x, y), color.rgb()));
+                }
+            }
+        }
+    }
+
+    void testColorizeMatchesQColor() {
+        const QImage src = opaqueImage();
+        Layer layer;
+        layer.setValue(200);
+        layer.setDelta(-50);
+        const QImage img = FxColorize().applyEffect(src, layer);
+        for (int y = 0; y < src.height(); ++y) {
+            for (int x = 0; x < src.width(); ++x) {
+                const QRgb p = src.pixel(x, y);
+                const int l = qRed(p) * 0.2126 + qGreen(p) * 0.7152 +
+                              qBlue(p) * 0.0722;
+                QColor color;
+                color.setHsl(200, 77, l);
+                QVERIFY(nearlyEqual(img.pixel(x, y), color.rgb()));
+            }
+        }
+    }
+
+    void testHueTranslucent() {
+        // Works on the straight colour, alpha is kept
+        QImage img(1, 1, QImage::Format_ARGB32_Premultiplied);
+        img.setPixel(0, 0, qPremultiply(qRgba(200, 0, 0, 128)));
+        FxKernels::hue(img, 120);
+        QRgb out = qUnpremultiply(img.pixel(0, 0));
+        QVERIFY(qAbs(qGreen(out) - 200) <= 2);
+        QVERIFY(qRed(out) <= 1);
+        QCOMPARE(qAlpha(out), 128);
+    }
+
+    void testParallelMatchesSerial() {
+        QImage src(512, 700, QImage::Format_ARGB32_Premultiplied);
+        QRandomGenerator rnd(4711);
+        for (int y = 0; y < src.height(); ++y) {
+            QRgb *line = (QRgb *)src.scanLine(y);
+            for (int x = 0; x < src.width(); ++x) {
+                const int a = rnd.bounded(256);
+                line[x] = qRgba(rnd.bounded(a + 1), rnd.bounded(a + 1),
+                                rnd.bounded(a + 1), a);
+            }
+        }
+        QImage serial[3] = {src, src, src};
+        FxKernels::setParallel(false);
+        FxKernels::hue(serial[0], 77);
+        FxKernels::saturation(serial[1], -30);
+        FxKernels::colorize(serial[2], 30, 200);
+        FxKernels::setParallel(true);
+        QImage parallel[3] = {src, src, src};
+        FxKernels::hue(parallel[0], 77);
+        FxKernels::saturation(parallel[1], -30);
+        FxKernels::colorize(parallel[2], 30, 200);
+        for (int a = 0; a < 3; ++a) {
+            QCOMPARE(parallel[a], serial[a]);
+        }
+    }
+
+    void testBlurIsasMatchScalar() {
+        QImage argb = randomImage().scaled(301, 157);
+        QImage alpha = argb.convertToFormat(QImage::Format_Alpha8);
+        const FxKernels::Isa best = FxKernels::getIsa();
+        for (const QImage &src : {argb, alpha}) {
+            for (const int radius : {1, 4, 40, 400}) {
+                for (const bool gaussian : {false, true}) {
+                    QImage expected = src;
+                    FxKernels::setIsa(FxKernels::ISA_SCALAR);
+                    FxKernels::boxBlur(expected, radius, gaussian);
+                    QImage img = src;
+                    FxKernels::setIsa(best);
+                    FxKernels::boxBlur(img, radius, gaussian);
+                    QCOMPARE(img, expected);
+                }
+            }
+        }
+    }
+
+    void testBlurUniform() {
+        // A uniform translucent colour must stay as it is, also at the edges
+        QImage img(40, 30, QImage::Format_ARGB32_Premultiplied);
+        const QRgb colour = qPremultiply(qRgba(200, 100, 50, 128));
+        img.fill(colour);
+        FxKernels::boxBlur(img, 7, true);
+        QCOMPARE(img.pixel(0, 0), colour);
+        QCOMPARE(img.pixel(39, 29), colour);
+        QCOMPARE(img.pixel(20, 15), colour);
+    }
+
+    void testBlurBox() {
+        // Single white pixel spreads into a 3x3 box of 255 / 9
+        QImage img(9, 9, QImage::Format_Alpha8);
+        img.fill(0);
+        img.scanLine(4)[4] = 255;
+        FxKernels::boxBlur(img, 1);
+        QCOMPARE((int)img.constScanLine(3)[3], 28);
+        QCOMPARE((int)img.constScanLine(4)[4], 28);
+        QCOMPARE((int)img.constScanLine(2)[4], 0);
+    }
+
+    void testOpacity() {
+        QImage img(3, 1, QImage::Format_ARGB32_Premultiplied);
+        img.fill(qRgba(200, 100, 50, 255));
+        Layer layer;
+        layer.setOpacity(50);
+        FxOpacity effect;
+        QRgb out = effect.applyEffect(img, layer).pixel(2, 0);
+        QVERIFY(qAbs(qAlpha(out) - 128) <= 1);
+        QCOMPARE(qRed(out), 100);
+        QCOMPARE(qBlue(out), 25);
+    }
+
+    void testLutMatchesEffects() {
+        // Table as built by the compositor for consecutive per channel
+        // effects
+        QImage lut(256, 256, QImage::Format_ARGB32_Premultiplied);
+        for (int a = 0; a < 256; ++a) {
+            QRgb *line = (QRgb *)lut.scanLine(a);
+            for (int p = 0; p < 256; ++p) {
+                line[p] = qRgba(qMin(p, a), qMin(p, a), qMin(p, a), a);
+            }
+        }
+        Layer brightness;
+        brightness.setDelta(-60);
+        Layer opacity;
+        opacity.setOpacity(70);
+        lut = FxBrightness().applyEffect(lut, brightness);
+        lut = FxOpacity().applyEffect(lut, opacity);
+
+        const QImage src = randomImage();
+        QImage expected = FxBrightness().applyEffect(src, brightness);
+        expected = FxOpacity().applyEffect(expected, opacity);
+        QImage img = src;
+        FxKernels::applyLut(img, lut);
+        QCOMPARE(img, expected);
+    }
+
+    void testNeutralEffectsKeepPixels() {
+        const QImage src = randomImage();
+        Layer neutral;
+        neutral.setDelta(0);
+        neutral.setRed(0);
+        neutral.setGreen(0);
+        neutral.setBlue(0);
+        neutral.setOpacity(100);
+        QImage img = src;
+        img = FxBrightness().applyEffect(std::move(img), neutral);
+        img = FxContrast().applyEffect(std::move(img), neutral);
+        img = FxBalance().applyEffect(std::move(img), neutral);
+        img = FxOpacity().applyEffect(std::move(img), neutral);
+        QCOMPARE(img.format(), QImage::Format_ARGB32_Premultiplied);
+        QCOMPARE(img, src);
+    }
+
+    void testChainIsStable() {
+        const QImage src = randomImage().scaled(101, 67);
+        const QImage original = src.copy();
+        Layer layer;
+        layer.setDelta(30);
+        layer.setSoftness(2);
+        layer.setOpacity(80);
+        auto chain = [&layer](QImage img) {
+            img = FxBrightness().applyEffect(std::move(img), layer);
+            img = FxContrast().applyEffect(std::move(img), layer);
+            img = FxHue().applyEffect(std::move(img), layer);
+            img = FxSaturation().applyEffect(std::move(img), layer);
+            img = FxBlur().applyEffect(std::move(img), layer);
+            return FxOpacity().applyEffect(std::move(img), layer);
+        };
+        // Shared input is left alone, a moved in one gives the same result
+        const QImage shared = chain(src);
+        QCOMPARE(src, original);
+        QImage owned = src.copy();
+        QCOMPARE(chain(std::move(owned)), shared);
+        QCOMPARE(chain(src), shared);
+
+        QCOMPARE(shared.format(), QImage::Format_ARGB32_Premultiplied);
+        for (int y = 0; y < shared.height(); ++y) {
+            const QRgb *line = (const QRgb *)shared.constScanLine(y);
+            for (int x = 0; x < shared.width(); ++x) {
+                const int a = qAlpha(line[x]);
+                QVERIFY(qRed(line[x]) <= a && qGreen(line[x]) <= a &&
+                        qBlue(line[x]) <= a);
+            }
+        }
+    }
+};
+
+QTEST_MAIN(TestFxKernels)
+#include "test_fxkernels.moc"
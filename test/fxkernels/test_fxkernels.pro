@@ -0,0 +1,39 @@
+TEMPLATE = app
+TARGET = test_fxkernels
+DEPENDPATH += .
+INCLUDEPATH += ../../src
+CONFIG += debug
+QT += core gui testlib
+QMAKE_CXXFLAGS += -std=c++17
+
+CONFIG(release, debug|release):DEFINES += QT_NO_DEBUG_OUTPUT
+
+include(../../VERSION.ini)
+DEFINES+=VERSION=\\\"$$VERSION\\\"
+
+HEADERS += ../../src/fxbalance.h \
+           ../../src/fxblur.h \
+           ../../src/fxbrightness.h \
+           ../../src/fxcolorize.h \
+           ../../src/fxcontrast.h \
+           ../../src/fxhue.h \
+           ../../src/fxkernels.h \
+           ../../src/fxopacity.h \
+           ../../src/fxsaturation.h \
+           ../../src/imagewriter.h \
+           ../../src/layer.h \
+           ../../src/taskpool.h
+
+SOURCES += test_fxkernels.cpp \
+           ../../src/fxbalance.cpp \
+           ../../src/fxblur.cpp \
+           ../../src/fxbrightness.cpp \
+           ../../src/fxcolorize.cpp \
+           ../../src/fxcontrast.cpp \
+           ../../src/fxhue.cpp \
+           ../../src/fxkernels.cpp \
+           ../../src/fxopacity.cpp \
+           ../../src/fxsaturation.cpp \
+           ../../src/imagewriter.cpp \
+           ../../src/layer.cpp \
+           ../../src/taskpool.cpp
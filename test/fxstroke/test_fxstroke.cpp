@@ -0,0 +1,99 @@
+#include "fxstroke.h"
+#include "layer.h"
+
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QTest>
+
+class TestFxStroke : public QObject {
+    Q_OBJECT
+
+private:
+    // The former implementation: dilate the alpha with a 3x3 square
+    // 'width' times
+    static QImage dilated(const QImage &src, int width, QRgb colour) {
+        QImage buffer1(src.width() + width * 2, src.height() + width * 2,
+                       QImage::Format_ARGB32_Premultiplied);
+        buffer1.fill(Qt::transparent);
+        QPainter painter(&buffer1);
+        painter.drawImage(width, width, src);
+        painter.end();
+        QImage buffer2(buffer1.size(), QImage::Format_ARGB32_Premultiplied);
+        buffer2.fill(Qt::transparent);
+        for (int a = 0; a < width; ++a) {
+            for (int y = 0; y < buffer1.height(); ++y) {
+                for (int x = 0; x < buffer1.width(); ++x) {
+                    int alpha = qAlpha(buffer1.pixel(x, y));
+                    if (alpha == 0) {
+                        continue;
+                    }
+                    for (int i = -1; i <= 1; ++i) {
+                        for (int j = -1; j <= 1; ++j) {
+                            if (qAlpha(buffer2.pixel(x + j, y + i)) < alpha) {
+                                buffer2.setPixel(
+                                    x + j, y + i,
+                                    qPremultiply(qRgba(qRed(colour),
+                                                       qGreen(colour),
+                                                       qBlue(colour), alpha)));
+                            }
+                        }
+                    }
+                }
+            }
+            buffer1 = buffer2.copy();
+        }
+        painter.begin(&buffer2);
+        painter.drawImage(width, width, src);
+        painter.end();
+        return buffer2;
+    }
+
+    static QImage randomImage() {
+        QRandomGenerator rnd(4711);
+        QImage img(23, 17, QImage::Format_ARGB32_Premultiplied);
+        img.fill(Qt::transparent);
+        for (int a = 0; a < 40; ++a) {
+            const int alpha = rnd.bounded(256);
+            img.setPixel(rnd.bounded(img.width()), rnd.bounded(img.height()),
+                         qPremultiply(qRgba(rnd.bounded(256), rnd.bounded(256),
+                                            rnd.bounded(256), alpha)));
+        }
+        return img;
+    }
+
+private slots:
+    void testMatchesDilation() {
+        const QImage src = randomImage();
+        for (const int width : {-30, -3, 0, 1, 2, 5, 12}) {
+            Layer layer;
+            layer.setWidth(width);
+            layer.setRed(10);
+            layer.setGreen(200);
+            layer.setBlue(30);
+            // Negative widths draw no stroke
+            QImage expected =
+                dilated(src, qMax(0, width), qRgb(10, 200, 30));
+            QCOMPARE(FxStroke().applyEffect(src, layer), expected);
+        }
+    }
+
+    void testAntialiased() {
+        QImage src(1, 1, QImage::Format_ARGB32_Premultiplied);
+        src.fill(Qt::white);
+        Layer layer;
+        layer.setWidth(3);
+        layer.setRed(0);
+        layer.setAntialias(true);
+        QImage img = FxStroke().applyEffect(src, layer);
+        QCOMPARE(img.size(), QSize(7, 7));
+        // Round: the corner is outside, the edge centres inside
+        QCOMPARE(qAlpha(img.pixel(0, 0)), 0);
+        QCOMPARE(qAlpha(img.pixel(0, 3)), 255);
+        QCOMPARE(img.pixel(3, 3), qRgb(255, 255, 255));
+        // Partly covered at distance sqrt(10), 4 - 3.16 = 0.84
+        QVERIFY(qAbs(qAlpha(img.pixel(0, 2)) - 214) <= 1);
+    }
+};
+
+QTEST_MAIN(TestFxStroke)
+#include "test_fxstroke.moc"
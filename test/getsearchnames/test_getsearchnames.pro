@@ -24,6 +24,7 @@ HEADERS += ../../src/abstractscraper.h  \
              ../../src/crc32.h \
              ../../src/esgamelist.h \
              ../../src/gameentry.h \
+             ../../src/imgtools.h \
              ../../src/igdb.h \
              ../../src/mobygames.h \
              ../../src/nametools.h \
@@ -34,7 +35,9 @@ HEADERS += ../../src/abstractscraper.h  \
              ../../src/queue.h \ 
              ../../src/screenscraper.h \
              ../../src/settings.h \
-             ../../src/strtools.h 
+             ../../src/strtools.h \
+             ../../src/taskpool.h \
+             ../../src/videoconverter.h
 
 SOURCES +=  test_getsearchnames.cpp \
              ../../src/abstractscraper.cpp \
@@ -45,6 +48,7 @@ SOURCES +=  test_getsearchnames.cpp \
              ../../src/crc32.cpp \
              ../../src/esgamelist.cpp \
              ../../src/gameentry.cpp \
+             ../../src/imgtools.cpp \
              ../../src/igdb.cpp \
              ../../src/mobygames.cpp \
              ../../src/nametools.cpp \
@@ -55,4 +59,6 @@ SOURCES +=  test_getsearchnames.cpp \
              ../../src/queue.cpp \
              ../../src/screenscraper.cpp \
              ../../src/settings.cpp \
-             ../../src/strtools.cpp
+             ../../src/strtools.cpp \
+             ../../src/taskpool.cpp \
+             ../../src/videoconverter.cpp
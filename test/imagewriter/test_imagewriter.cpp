@@ -0,0 +1,93 @@
+#include "imagewriter.h"
+#include "layer.h"
+
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+class TestImageWriter : public QObject {
+    Q_OBJECT
+
+private:
+    QTemporaryDir tmpDir;
+
+    // Noise compresses poorly, so the zlib level makes a difference
+    static QImage noise() {
+        QImage img(200, 100, QImage::Format_ARGB32_Premultiplied);
+        quint32 seed = 4711;
+        for (int y = 0; y < img.height(); ++y) {
+            QRgb *line = (QRgb *)img.scanLine(y);
+            for (int x = 0; x < img.width(); ++x) {
+                seed = seed * 1103515245 + 12345;
+                line[x] = qRgb(x, y, (seed >> 16) & 0x0f);
+            }
+        }
+        return img;
+    }
+
+private slots:
+    void testPngLevels() {
+        const QString fast = tmpDir.filePath("fast.png");
+        const QString small = tmpDir.filePath("small.png");
+        ImageWriter::write(noise(), fast, "png", 0, -1);
+        ImageWriter::write(noise(), small, "png", 9, -1);
+        QVERIFY(ImageWriter::waitForDone().isEmpty());
+        QVERIFY(QFileInfo(fast).size() > QFileInfo(small).size());
+        QImage fastImg(fast);
+        QImage smallImg(small);
+        QCOMPARE(fastImg.convertToFormat(QImage::Format_ARGB32),
+                 smallImg.convertToFormat(QImage::Format_ARGB32));
+    }
+
+    void testLayerFormat() {
+        Layer output;
+        output.setFormat("JPEG");
+        QCOMPARE(output.format, QByteArray("jpg"));
+        output.setQuality(150);
+        QCOMPARE(output.quality, 100);
+        output.setCompression(-5);
+        QCOMPARE(output.compression, -1);
+    }
+
+    void testLayerSave() {
+        Layer output;
+        output.setFormat("jpg");
+        output.setQuality(80);
+        const QString filename = tmpDir.filePath("out.jpg");
+        QVERIFY(output.save(noise(), filename));
+        QVERIFY(ImageWriter::waitForDone().isEmpty());
+        QImage img(filename);
+        QCOMPARE(img.size(), QSize(200, 100));
+        QVERIFY(!img.hasAlphaChannel());
+
+        // Fully transparent outputs are skipped
+        Layer empty;
+        QImage transparent(10, 10, QImage::Format_ARGB32_Premultiplied);
+        transparent.fill(Qt::transparent);
+        QVERIFY(!empty.save(transparent, tmpDir.filePath("empty.png")));
+    }
+
+    void testFailureIsReported() {
+        const QString filename = tmpDir.filePath("missing/out.png");
+        bool written = true;
+        ImageWriter::write(noise(), filename, "png", -1, -1,
+                           [&written](bool ok) { written = ok; });
+        QCOMPARE(ImageWriter::waitForDone(), QStringList({filename}));
+        QVERIFY(!written);
+        QVERIFY(ImageWriter::waitForDone().isEmpty());
+    }
+
+    void testFailureKeepsFile() {
+        const QString filename = tmpDir.filePath("keep.png");
+        ImageWriter::write(noise(), filename, "png", -1, -1);
+        QVERIFY(ImageWriter::waitForDone().isEmpty());
+        const qint64 size = QFileInfo(filename).size();
+        // Null images can't be encoded, the earlier file stays
+        ImageWriter::write(QImage(), filename, "png", -1, -1);
+        QCOMPARE(ImageWriter::waitForDone(), QStringList({filename}));
+        QCOMPARE(QFileInfo(filename).size(), size);
+    }
+};
+
+QTEST_MAIN(TestImageWriter)
+#include "test_imagewriter.moc"
@@ -0,0 +1,19 @@
+TEMPLATE = app
+TARGET = test_imagewriter
+DEPENDPATH += .
+INCLUDEPATH += ../../src
+CONFIG += debug
+QT += core gui testlib
+QMAKE_CXXFLAGS += -std=c++17
+
+CONFIG(release, debug|release):DEFINES += QT_NO_DEBUG_OUTPUT
+
+include(../../VERSION.ini)
+DEFINES+=VERSION=\\\"$$VERSION\\\"
+
+HEADERS += ../../src/imagewriter.h \
+           ../../src/layer.h
+
+SOURCES += test_imagewriter.cpp \
+           ../../src/imagewriter.cpp \
+           ../../src/layer.cpp
@@ -155,6 +155,10 @@ void TestSettings::testConfigIniMain() {
     QCOMPARE(config.frontend, exp);
     exp = settings.value("addExtensions");
     QCOMPARE(config.addExtensions, exp);
+    exp = settings.value("artworkPassthrough");
+    QCOMPARE(config.artworkPassthrough, exp);
+    exp = settings.value("artworkPixelBudget");
+    QCOMPARE(config.artworkPixelBudget, exp);
     exp = settings.value("artworkXml");
     QCOMPARE(config.artworkConfig, exp);
     exp = settings.value("brackets");
@@ -272,6 +276,8 @@ void TestSettings::testConfigIniMain() {
     QCOMPARE(config.videoConvertCommand, exp);
     exp = settings.value("videoConvertExtension");
     QCOMPARE(config.videoConvertExtension, exp);
+    exp = settings.value("videoConvertJobs");
+    QCOMPARE(config.videoConvertJobs, exp);
     exp = settings.value("videos");
     QCOMPARE(config.videos, exp);
     exp = settings.value("videoSizeLimit");
@@ -18,18 +18,24 @@ HEADERS += test_settings.h \
            ../../src/cli.h \
            ../../src/config.h \
            ../../src/gameentry.h \
+           ../../src/imgtools.h \
            ../../src/nametools.h \
            ../../src/platform.h \
            ../../src/queue.h \
            ../../src/settings.h \
-           ../../src/strtools.h
+           ../../src/strtools.h \
+           ../../src/taskpool.h \
+           ../../src/videoconverter.h
 SOURCES += test_settings.cpp \
            ../../src/cache.cpp \
            ../../src/cli.cpp \
            ../../src/config.cpp \
            ../../src/gameentry.cpp \
+           ../../src/imgtools.cpp \
            ../../src/nametools.cpp \
            ../../src/platform.cpp \
            ../../src/queue.cpp \           
            ../../src/settings.cpp \
-           ../../src/strtools.cpp
\ No newline at end of file
+           ../../src/strtools.cpp \
+           ../../src/taskpool.cpp \
+           ../../src/videoconverter.cpp
\ No newline at end of file